@@ -2,7 +2,24 @@
 
 #include "../../Mist_common/include/UtilityMacros.h"
 #include "Hashing.h"
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
+
+// Define as 1 to use 64 bit hash ids, reducing the odds of collisions in large registries
+#ifndef MIST_HASHID_64
+#define MIST_HASHID_64 0
+#endif
+
+// Functions marked MIST_CONSTEVAL are guaranteed to be evaluated at compile time when the compiler supports consteval
+#if defined(__cpp_consteval)
+#define MIST_CONSTEVAL consteval
+#else
+#define MIST_CONSTEVAL constexpr
+#endif
+
+// Create the HashID of a string literal, the hash is always computed at compile time
+#define MIST_HASHID(name) ::Mist::HashID(::std::integral_constant<::Mist::HashID::ValueType, ::Mist::djb2::Hash<::Mist::HashID::ValueType>(name)>::value)
 
 MIST_NAMESPACE
 
@@ -12,9 +29,17 @@ class HashID {
 
 public:
 
+	// -Types-
+
+#if MIST_HASHID_64
+	using ValueType = uint64_t;
+#else
+	using ValueType = uint32_t;
+#endif
+
 	// -Public API-
 
-	inline uint32_t GetValue() const;
+	inline constexpr ValueType GetValue() const;
 	
 	inline bool operator==(const char* name);
 
@@ -22,30 +47,50 @@ public:
 
 	inline constexpr HashID(const char* name);
 
+	// Hash a runtime string of known length, produces the same value as hashing the null terminated string
+	inline HashID(const char* name, size_t length);
+
 	// Creates a hash id with a directly initialized value
-	inline explicit HashID(uint32_t hashValue);
+	inline constexpr explicit HashID(ValueType hashValue);
 
 private:
-	uint32_t m_HashValue = 0;
+	ValueType m_HashValue = 0;
 
 };
 
+namespace Literals {
+
+	// Create the HashID of a string literal as "Name"_hash
+	// @Detail: Evaluated at compile time when consteval is supported, use MIST_HASHID otherwise
+	inline MIST_CONSTEVAL HashID operator"" _hash(const char* name, size_t length);
+}
+
 
 // -Implementation-
 
-inline uint32_t HashID::GetValue() const {
+inline constexpr HashID::ValueType HashID::GetValue() const {
 	
 	return m_HashValue;
 }
 
 inline bool HashID::operator==(const char* name) {
 
-	return m_HashValue == djb2::Hash(name);
+	return m_HashValue == djb2::Hash<ValueType>(name);
 }
 
-inline constexpr HashID::HashID(const char* name) : m_HashValue(djb2::Hash(name)) {}
+inline constexpr HashID::HashID(const char* name) : m_HashValue(djb2::Hash<ValueType>(name)) {}
+
+inline HashID::HashID(const char* name, size_t length) : m_HashValue(djb2::Hash<ValueType>(name, length)) {}
+
+inline constexpr HashID::HashID(ValueType hashValue) : m_HashValue(hashValue) {}
 
-inline HashID::HashID(uint32_t hashValue) : m_HashValue(hashValue) {}
+namespace Literals {
+
+	inline MIST_CONSTEVAL HashID operator"" _hash(const char* name, size_t) {
+
+		return HashID(name);
+	}
+}
 
 
 MIST_NAMESPACE_END
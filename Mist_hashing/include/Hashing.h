@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../Mist_common/include/UtilityMacros.h"
+#include <cstddef>
 #include <cstdint>
 
 MIST_NAMESPACE
@@ -10,13 +11,65 @@ namespace djb2 {
 
 	namespace Detail {
 		const uint32_t BEGIN_HASH_VALUE = 5381;
+
+		// Raise the djb2 multiplier to the power of exponent
+		template< typename ValueType >
+		constexpr ValueType MultiplierPower(size_t exponent) {
+
+			ValueType power = 1;
+			for (size_t i = 0; i < exponent; ++i) {
+				power *= 33;
+			}
+			return power;
+		}
 	}
 
 	// Hash a string at compile time, Source on: https://stackoverflow.com/questions/7666509/hash-function-for-string
 	// Algorithm Source: http://www.cse.yorku.ca/~oz/hash.html by Dan Bernstein
 	// Special thanks to https://www.github.com/xoorath for pointing out that the method presented uses unsigned long which would use a 32 bit integer and not a 64 bit integer.
-	constexpr uint32_t Hash(const char* string, const uint32_t hash = Detail::BEGIN_HASH_VALUE) {
-		return (string[0] == '\0') ? 0 : ((hash << 5) + hash) + string[1] + Hash(&string[1], hash);
+	// @Detail: The hash is computed iteratively, long strings don't run into constexpr recursion limits.
+	// ValueType selects a 32 or 64 bit hash
+	template< typename ValueType = uint32_t >
+	constexpr ValueType Hash(const char* string) {
+
+		ValueType hash = Detail::BEGIN_HASH_VALUE;
+		for (; *string != '\0'; ++string) {
+			hash = hash * 33 + static_cast<unsigned char>(*string);
+		}
+		return hash;
+	}
+
+	// Hash a string of known length at runtime, produces the same value as Hash
+	// @Detail: Characters are consumed in blocks of 8 whose terms don't depend on each other,
+	// which lets the compiler vectorize or interleave the multiplications
+	template< typename ValueType = uint32_t >
+	inline ValueType Hash(const char* string, size_t length) {
+
+		// hash * 33^8 + c0 * 33^7 + ... + c7 is equal to 8 sequential steps of hash * 33 + c
+		constexpr ValueType POWER_2 = Detail::MultiplierPower<ValueType>(2);
+		constexpr ValueType POWER_3 = Detail::MultiplierPower<ValueType>(3);
+		constexpr ValueType POWER_4 = Detail::MultiplierPower<ValueType>(4);
+		constexpr ValueType POWER_5 = Detail::MultiplierPower<ValueType>(5);
+		constexpr ValueType POWER_6 = Detail::MultiplierPower<ValueType>(6);
+		constexpr ValueType POWER_7 = Detail::MultiplierPower<ValueType>(7);
+		constexpr ValueType POWER_8 = Detail::MultiplierPower<ValueType>(8);
+
+		const unsigned char* characters = reinterpret_cast<const unsigned char*>(string);
+
+		ValueType hash = Detail::BEGIN_HASH_VALUE;
+		size_t i = 0;
+		for (; i + 8 <= length; i += 8) {
+
+			const unsigned char* block = characters + i;
+			hash = hash * POWER_8
+				+ block[0] * POWER_7 + block[1] * POWER_6 + block[2] * POWER_5 + block[3] * POWER_4
+				+ block[4] * POWER_3 + block[5] * POWER_2 + block[6] * ValueType(33) + block[7];
+		}
+
+		for (; i < length; ++i) {
+			hash = hash * 33 + characters[i];
+		}
+		return hash;
 	}
 }
 
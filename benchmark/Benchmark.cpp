@@ -0,0 +1,503 @@
+#include "../include/Reflection.h"
+#include "../include/PreMain.h"
+#include "../include/BinarySerializer.h"
+#include "../include/ObjectDiff.h"
+#include "../include/StructuralHasher.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+// Reflection micro-benchmarks.
+// Every reflected hot path is measured next to the equivalent direct C++ call
+// and reported as ns/op, allocations/op and per-sample percentiles.
+// Lookups use compile time ids so the rows time the lookup itself, string hashing has its own rows.
+// @Detail: Build this file together with source/Reflection.cpp, source/BinarySerializer.cpp, source/ObjectDiff.cpp,
+// source/StructuralHasher.cpp and source/LayoutBuilder.cpp as its own executable.
+
+// -Allocation Tracking-
+
+#if defined(_MSC_VER)
+#define MIST_BENCHMARK_NOINLINE __declspec(noinline)
+#else
+#define MIST_BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+namespace {
+	std::atomic<size_t> g_AllocationCount(0);
+
+	// Every replaced operator allocates and releases through these, kept out of line so the compiler
+	// doesn't pair an inlined free with the allocation of a new expression
+	MIST_BENCHMARK_NOINLINE void* Allocate(size_t size) {
+
+		g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+		if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+			return memory;
+		}
+		throw std::bad_alloc();
+	}
+
+	MIST_BENCHMARK_NOINLINE void Release(void* memory) noexcept {
+
+		std::free(memory);
+	}
+}
+
+void* operator new(size_t size) {
+
+	return Allocate(size);
+}
+
+void* operator new[](size_t size) {
+
+	return Allocate(size);
+}
+
+void operator delete(void* memory) noexcept {
+
+	Release(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+
+	Release(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+
+	Release(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+
+	Release(memory);
+}
+
+#if defined(__cpp_aligned_new) && !defined(_MSC_VER)
+
+// Over aligned allocations are rounded up to a multiple of their alignment as required by aligned_alloc,
+// MSVC keeps its own aligned operators since its aligned memory must be released with _aligned_free
+void* operator new(size_t size, std::align_val_t alignment) {
+
+	g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	const size_t align = static_cast<size_t>(alignment);
+	if (void* memory = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+
+	return operator new(size, alignment);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+
+	Release(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+
+	Release(memory);
+}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept {
+
+	Release(memory);
+}
+
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept {
+
+	Release(memory);
+}
+
+#endif
+
+// -Harness-
+
+namespace {
+
+	const size_t SAMPLE_COUNT = 101;
+	const std::chrono::nanoseconds TARGET_SAMPLE_TIME = std::chrono::microseconds(200);
+
+	// Prevent the optimizer from discarding a value that is only computed for the benchmark
+	template< typename ValueType >
+	void DoNotOptimize(const ValueType& value) {
+
+#if defined(_MSC_VER)
+		static volatile const void* sink;
+		sink = &value;
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	struct BenchmarkResult {
+		double m_NanosecondsPerOp = 0.0;
+		double m_AllocationsPerOp = 0.0;
+		double m_P50 = 0.0;
+		double m_P90 = 0.0;
+		double m_P99 = 0.0;
+	};
+
+	template< typename BodyType >
+	double TimeSample(BodyType& body, size_t iterations) {
+
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; ++i) {
+			body();
+		}
+		auto end = std::chrono::steady_clock::now();
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+	}
+
+	// Run the body in samples of a calibrated iteration count
+	// @Detail: Percentiles are taken over the per-sample ns/op values
+	template< typename BodyType >
+	BenchmarkResult RunBenchmark(BodyType body) {
+
+		// Calibrate so that a sample lasts roughly TARGET_SAMPLE_TIME
+		size_t iterations = 1;
+		while (TimeSample(body, iterations) < TARGET_SAMPLE_TIME.count() && iterations < (size_t(1) << 24)) {
+			iterations *= 2;
+		}
+
+		std::vector<double> samples;
+		samples.reserve(SAMPLE_COUNT);
+
+		size_t allocationsBefore = g_AllocationCount.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < SAMPLE_COUNT; ++i) {
+			samples.push_back(TimeSample(body, iterations) / static_cast<double>(iterations));
+		}
+		size_t allocationsAfter = g_AllocationCount.load(std::memory_order_relaxed);
+
+		BenchmarkResult result;
+		double total = 0.0;
+		for (double sample : samples) {
+			total += sample;
+		}
+		result.m_NanosecondsPerOp = total / static_cast<double>(samples.size());
+		// The samples vector was reserved up front so the harness itself does not allocate
+		result.m_AllocationsPerOp = static_cast<double>(allocationsAfter - allocationsBefore) / static_cast<double>(iterations * SAMPLE_COUNT);
+
+		std::sort(samples.begin(), samples.end());
+		result.m_P50 = samples[samples.size() * 50 / 100];
+		result.m_P90 = samples[samples.size() * 90 / 100];
+		result.m_P99 = samples[samples.size() * 99 / 100];
+		return result;
+	}
+
+	void PrintHeader() {
+
+		std::printf("%-42s %10s %10s %10s %10s %10s %9s\n", "Benchmark", "ns/op", "allocs/op", "p50", "p90", "p99", "overhead");
+	}
+
+	void PrintResult(const char* name, const BenchmarkResult& result, const BenchmarkResult* direct) {
+
+		std::printf("%-42s %10.2f %10.2f %10.2f %10.2f %10.2f", name, result.m_NanosecondsPerOp, result.m_AllocationsPerOp, result.m_P50, result.m_P90, result.m_P99);
+		if (direct != nullptr && direct->m_NanosecondsPerOp > 0.0) {
+			std::printf(" %8.1fx", result.m_NanosecondsPerOp / direct->m_NanosecondsPerOp);
+		}
+		std::printf("\n");
+	}
+
+	// Run the direct and reflected variants of an operation and report them side by side
+	template< typename DirectType, typename ReflectedType >
+	void Compare(const char* name, DirectType direct, ReflectedType reflected) {
+
+		BenchmarkResult directResult = RunBenchmark(direct);
+		BenchmarkResult reflectedResult = RunBenchmark(reflected);
+
+		std::printf("%s\n", name);
+		PrintResult("  direct", directResult, nullptr);
+		PrintResult("  reflected", reflectedResult, &directResult);
+	}
+}
+
+// -Benchmark Types-
+
+class BenchObject {
+
+public:
+
+	BenchObject() = default;
+	explicit BenchObject(size_t value) : m_Value(value) {}
+
+	size_t Add(size_t value) {
+		m_Value += value;
+		return m_Value;
+	}
+
+	size_t m_Value = 0;
+};
+
+struct BenchTag {
+	size_t m_Priority = 1;
+};
+
+struct BenchParticle {
+	float m_X = 0.0f;
+	float m_Y = 0.0f;
+	float m_Z = 0.0f;
+	uint32_t m_Color = 0;
+};
+
+// Padding after m_Id splits the record into two runs
+struct BenchRecord {
+	uint32_t m_Id = 0;
+	BenchParticle m_Particle;
+	uint64_t m_Flags = 0;
+};
+
+#if defined(_MSC_VER)
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+size_t BenchFunction(size_t value) {
+	return value + 1;
+}
+
+Mist::Reflection g_Reflection;
+
+namespace {
+
+	Mist::PreMainCall BenchObjectRegister([]() {
+
+		Mist::TypeInfo* type = g_Reflection.AddType<BenchObject>("BenchObject");
+		type->AddConstructor<BenchObject>();
+		type->AddConstructor<BenchObject, size_t>();
+		type->AddMethod("Add", &BenchObject::Add);
+		type->AddMember("m_Value", &BenchObject::m_Value);
+		type->GetMetaData()->Add("Tag", BenchTag());
+
+		g_Reflection.AddGlobalFunction("BenchFunction", &BenchFunction);
+
+		Mist::TypeInfo* particle = g_Reflection.AddType<BenchParticle>("BenchParticle");
+		particle->AddMember("m_X", &BenchParticle::m_X);
+		particle->AddMember("m_Y", &BenchParticle::m_Y);
+		particle->AddMember("m_Z", &BenchParticle::m_Z);
+		particle->AddMember("m_Color", &BenchParticle::m_Color);
+
+		Mist::TypeInfo* record = g_Reflection.AddType<BenchRecord>("BenchRecord");
+		record->AddMember("m_Id", &BenchRecord::m_Id);
+		record->AddMember("m_Particle", &BenchRecord::m_Particle);
+		record->AddMember("m_Flags", &BenchRecord::m_Flags);
+	});
+}
+
+// -Benchmarks-
+
+int main() {
+
+	PrintHeader();
+
+	Mist::TypeInfo* type = g_Reflection.GetType("BenchObject");
+	Mist::MethodInfo* method = type->GetMethodInfo("Add");
+	Mist::MemberInfo* member = type->GetMemberInfo("m_Value");
+	Mist::MetaData* metaData = type->GetMetaData();
+	Mist::GlobalFunction* function = g_Reflection.GetGlobalFunction("BenchFunction");
+
+	BenchObject object;
+	BenchTag directTag;
+	Mist::TypeInfo* volatile cachedType = type;
+	Mist::MethodInfo* volatile cachedMethod = method;
+	Mist::MemberInfo* volatile cachedMember = member;
+
+	Compare("Reflection::GetType",
+		[&]() { DoNotOptimize(cachedType); },
+		[&]() { DoNotOptimize(g_Reflection.GetType(MIST_HASHID("BenchObject"))); });
+
+	Compare("TypeInfo::GetMethodInfo",
+		[&]() { DoNotOptimize(cachedMethod); },
+		[&]() { DoNotOptimize(type->GetMethodInfo(MIST_HASHID("Add"))); });
+
+	Compare("TypeInfo::GetMemberInfo",
+		[&]() { DoNotOptimize(cachedMember); },
+		[&]() { DoNotOptimize(type->GetMemberInfo(MIST_HASHID("m_Value"))); });
+
+	Compare("MethodInfo::Invoke",
+		[&]() { DoNotOptimize(object.Add(1)); },
+		[&]() { DoNotOptimize(method->Invoke<size_t, BenchObject, size_t>(&object, 1)); });
+
+	Mist::MethodInfo::Bound<size_t, BenchObject, size_t> boundMethod = method->Bind<size_t, BenchObject, size_t>();
+	Compare("MethodInfo::Bind handle",
+		[&]() { DoNotOptimize(object.Add(1)); },
+		[&]() { DoNotOptimize(boundMethod(&object, 1)); });
+
+	Compare("MemberInfo::Get",
+		[&]() { DoNotOptimize(&object.m_Value); },
+		[&]() { DoNotOptimize(member->Get<size_t>(&object)); });
+
+	const size_t GATHER_COUNT = 1024;
+	std::vector<BenchObject> gatherObjects(GATHER_COUNT);
+	std::vector<size_t> gatherValues(GATHER_COUNT);
+	Compare("MemberInfo::GatherStrided (1024 objects)",
+		[&]() {
+			for (size_t i = 0; i < GATHER_COUNT; ++i) {
+				gatherValues[i] = gatherObjects[i].m_Value;
+			}
+			DoNotOptimize(gatherValues[0]);
+		},
+		[&]() {
+			member->GatherStrided(gatherObjects.data(), sizeof(BenchObject), GATHER_COUNT, gatherValues.data());
+			DoNotOptimize(gatherValues[0]);
+		});
+
+	std::vector<BenchObject*> batchObjects;
+	std::vector<size_t> batchArguments(GATHER_COUNT, 1);
+	for (BenchObject& gatherObject : gatherObjects) {
+		batchObjects.push_back(&gatherObject);
+	}
+	Compare("MethodInfo::InvokeBatch (1024 objects)",
+		[&]() {
+			for (size_t i = 0; i < GATHER_COUNT; ++i) {
+				gatherValues[i] = batchObjects[i]->Add(batchArguments[i]);
+			}
+			DoNotOptimize(gatherValues[0]);
+		},
+		[&]() {
+			method->InvokeBatch<size_t, BenchObject, size_t>(batchObjects.data(), GATHER_COUNT, gatherValues.data(), batchArguments.data());
+			DoNotOptimize(gatherValues[0]);
+		});
+
+	Compare("TypeInfo::Create",
+		[&]() { BenchObject* created = new BenchObject(1); DoNotOptimize(created); delete created; },
+		[&]() { BenchObject* created = type->Create<BenchObject, size_t>(1); DoNotOptimize(created); delete created; });
+
+	typename std::aligned_storage<sizeof(BenchObject), alignof(BenchObject)>::type createStorage;
+	Compare("TypeInfo::CreateAt",
+		[&]() { BenchObject* created = new (&createStorage) BenchObject(1); DoNotOptimize(created); created->~BenchObject(); },
+		[&]() { BenchObject* created = type->CreateAt<BenchObject, size_t>(&createStorage, 1); DoNotOptimize(created); type->DestroyAt(created); });
+
+	Mist::Type pooledBenchType;
+	pooledBenchType.DefineTypes<BenchObject>();
+	Mist::TypeInfo pooledType(std::move(pooledBenchType));
+	pooledType.AddConstructor<BenchObject, size_t>();
+	pooledType.EnablePool();
+	Compare("TypeInfo::Create pooled",
+		[&]() { BenchObject* created = new BenchObject(1); DoNotOptimize(created); delete created; },
+		[&]() { BenchObject* created = pooledType.Create<BenchObject, size_t>(1); DoNotOptimize(created); pooledType.Destroy(created); });
+
+	Compare("MetaData::Get",
+		[&]() { DoNotOptimize(directTag.m_Priority); },
+		[&]() { DoNotOptimize(metaData->Get<BenchTag>(MIST_HASHID("Tag"))->m_Priority); });
+
+	Compare("GlobalFunction::Invoke",
+		[&]() { DoNotOptimize(BenchFunction(1)); },
+		[&]() { DoNotOptimize(function->Invoke<size_t, size_t>(1)); });
+
+	Mist::BoundDelegate<size_t, size_t> boundFunction = function->Bind<size_t, size_t>();
+	Compare("GlobalFunction::Bind handle",
+		[&]() { DoNotOptimize(BenchFunction(1)); },
+		[&]() { DoNotOptimize(boundFunction(1)); });
+
+	// Serialization into a reused buffer, the direct rows are hand written serializers
+	Mist::BinarySerializer serializer(&g_Reflection);
+	std::vector<BenchParticle> particles(GATHER_COUNT);
+	std::vector<unsigned char> serialized;
+	serialized.reserve(GATHER_COUNT * sizeof(BenchParticle));
+	Compare("BinarySerializer::WriteArray (1024 objects)",
+		[&]() {
+			serialized.clear();
+			const unsigned char* begin = reinterpret_cast<const unsigned char*>(particles.data());
+			serialized.insert(serialized.end(), begin, begin + particles.size() * sizeof(BenchParticle));
+			DoNotOptimize(serialized.data());
+		},
+		[&]() {
+			serialized.clear();
+			serializer.WriteArray(particles.data(), particles.size(), &serialized);
+			DoNotOptimize(serialized.data());
+		});
+
+	BenchRecord benchRecord;
+	Compare("BinarySerializer::Write",
+		[&]() {
+			serialized.clear();
+			const unsigned char* begin = reinterpret_cast<const unsigned char*>(&benchRecord);
+			serialized.insert(serialized.end(), begin, begin + sizeof(uint32_t) + sizeof(BenchParticle));
+			serialized.insert(serialized.end(), begin + offsetof(BenchRecord, m_Flags), begin + sizeof(BenchRecord));
+			DoNotOptimize(serialized.data());
+		},
+		[&]() {
+			serialized.clear();
+			serializer.Write(benchRecord, &serialized);
+			DoNotOptimize(serialized.data());
+		});
+
+	// Patches of a single changed field, the direct row compares every field by hand
+	Mist::ObjectDiff objectDiff(&g_Reflection);
+	BenchRecord changedRecord = benchRecord;
+	changedRecord.m_Particle.m_Y = 1.0f;
+	auto diffField = [&](unsigned char index, const void* before, const void* after, size_t size) {
+		if (std::memcmp(before, after, size) != 0) {
+			serialized.push_back(index);
+			serialized.insert(serialized.end(), static_cast<const unsigned char*>(after), static_cast<const unsigned char*>(after) + size);
+		}
+	};
+	Compare("ObjectDiff::Diff (one changed field)",
+		[&]() {
+			serialized.clear();
+			diffField(1, &benchRecord.m_Id, &changedRecord.m_Id, sizeof(uint32_t));
+			diffField(2, &benchRecord.m_Particle.m_X, &changedRecord.m_Particle.m_X, sizeof(float));
+			diffField(3, &benchRecord.m_Particle.m_Y, &changedRecord.m_Particle.m_Y, sizeof(float));
+			diffField(4, &benchRecord.m_Particle.m_Z, &changedRecord.m_Particle.m_Z, sizeof(float));
+			diffField(5, &benchRecord.m_Particle.m_Color, &changedRecord.m_Particle.m_Color, sizeof(uint32_t));
+			diffField(6, &benchRecord.m_Flags, &changedRecord.m_Flags, sizeof(uint64_t));
+			serialized.push_back(0);
+			DoNotOptimize(serialized.data());
+		},
+		[&]() {
+			serialized.clear();
+			objectDiff.Diff(benchRecord, changedRecord, &serialized);
+			DoNotOptimize(serialized.data());
+		});
+
+	// Structural equality and hashing of equal records, the direct rows are hand written over the members
+	Mist::StructuralHasher hasher(&g_Reflection);
+	BenchRecord equalRecord = benchRecord;
+	Compare("StructuralHasher::Equals",
+		[&]() {
+			DoNotOptimize(benchRecord.m_Id == equalRecord.m_Id && benchRecord.m_Particle.m_X == equalRecord.m_Particle.m_X
+				&& benchRecord.m_Particle.m_Y == equalRecord.m_Particle.m_Y && benchRecord.m_Particle.m_Z == equalRecord.m_Particle.m_Z
+				&& benchRecord.m_Particle.m_Color == equalRecord.m_Particle.m_Color && benchRecord.m_Flags == equalRecord.m_Flags);
+		},
+		[&]() { DoNotOptimize(hasher.Equals(benchRecord, equalRecord)); });
+
+	Compare("StructuralHasher::Hash",
+		[&]() {
+			const char* begin = reinterpret_cast<const char*>(&benchRecord);
+			DoNotOptimize(Mist::djb2::Hash<uint64_t>(begin, sizeof(uint32_t) + sizeof(BenchParticle))
+				^ Mist::djb2::Hash<uint64_t>(begin + offsetof(BenchRecord, m_Flags), sizeof(uint64_t)));
+		},
+		[&]() { DoNotOptimize(hasher.Hash(benchRecord)); });
+
+	// Runtime strings, the direct row hashes one character at a time
+	const char* volatile runtimeName = "An_Extremely_Long_Reflected_Type_Name_Used_By_Data_Files";
+	const size_t runtimeNameLength = std::strlen(runtimeName);
+	Compare("HashID runtime string (56 characters)",
+		[&]() { DoNotOptimize(Mist::djb2::Hash<Mist::HashID::ValueType>(runtimeName)); },
+		[&]() { DoNotOptimize(Mist::HashID(runtimeName, runtimeNameLength).GetValue()); });
+
+	// Lookups once registration is frozen
+	g_Reflection.Freeze();
+
+	Compare("Reflection::GetType frozen",
+		[&]() { DoNotOptimize(cachedType); },
+		[&]() { DoNotOptimize(g_Reflection.GetType(MIST_HASHID("BenchObject"))); });
+
+	Compare("TypeInfo::GetMethodInfo frozen",
+		[&]() { DoNotOptimize(cachedMethod); },
+		[&]() { DoNotOptimize(type->GetMethodInfo(MIST_HASHID("Add"))); });
+
+	Compare("MetaData::Get frozen",
+		[&]() { DoNotOptimize(directTag.m_Priority); },
+		[&]() { DoNotOptimize(metaData->Get<BenchTag>(MIST_HASHID("Tag"))->m_Priority); });
+
+	return 0;
+}
@@ -1,9 +1,21 @@
 #pragma once
 
 #include <Mist_Common/include/UtilityMacros.h>
+#include "TypeId.h"
+#include <cstddef>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
+// Size in bytes of the inline buffer held by every Any.
+// Values whose storage fits in the buffer are held without a heap allocation.
+// @Detail: The storage of a value includes the pointer to its implementation table, the default of two pointers
+// holds any scalar or pointer inline while keeping sizeof(Any) at four pointers, raise it to hold larger values inline
+#ifndef MIST_ANY_BUFFER_SIZE
+#define MIST_ANY_BUFFER_SIZE (sizeof(void*) * 2)
+#endif
+
 MIST_NAMESPACE
 
 namespace Detail {
@@ -12,6 +24,7 @@ namespace Detail {
 
 // The Any class holds a variable of any type.
 // To retrieve the value however, the type requested must match the type of the value exactly.
+// @Detail: Small values that can be moved without throwing are stored inline, larger values are heap allocated.
 class Any {
 
 public:
@@ -40,6 +53,26 @@ public:
 	template< typename ValueType >
 	bool Is();
 
+	// Retrieve the identity of the held type, invalid if the Any is empty
+	inline TypeId GetTypeId() const;
+
+	// Determine if the value is stored in the inline buffer rather than on the heap
+	inline bool IsInline() const;
+
+	// Retrieve the address and size of the held value, null and 0 if the Any is empty
+	inline const void* GetData() const;
+	inline size_t GetSize() const;
+
+	// Determine if the held value can be copied bytewise
+	inline bool IsTriviallyCopyable() const;
+
+	// Retrieve the size of the value allocated on the heap, 0 if the value is inline or the Any is empty
+	inline size_t GetHeapSize() const;
+
+	// Determine if a value of ValueType would be stored in the inline buffer
+	template< typename ValueType >
+	static constexpr bool FitsInline();
+
 
 	// -Structors-
 
@@ -49,8 +82,8 @@ public:
 
 	// Initialize to nothing, allowing for later setting
 	inline Any();
-	
-	~Any() = default;
+
+	inline ~Any();
 
 	Any(const Any&) = delete;
 	Any& operator=(const Any&) = delete;
@@ -60,7 +93,23 @@ public:
 
 private:
 
-	std::unique_ptr<Detail::AnyImpl> m_Data;
+	// Destroy the held value and release its storage
+	inline void Reset();
+
+	// Take the value held by move, leaving move empty
+	inline void Steal(Any& move);
+
+	// Construct the value in the inline buffer
+	template< typename NewType >
+	void Emplace(NewType&& value, std::true_type isInline);
+
+	// Construct the value on the heap
+	template< typename NewType >
+	void Emplace(NewType&& value, std::false_type isInline);
+
+	Detail::AnyImpl* m_Data;
+	TypeId m_Type;
+	typename std::aligned_storage<MIST_ANY_BUFFER_SIZE, alignof(void*)>::type m_Buffer;
 
 };
 
@@ -69,6 +118,17 @@ namespace Detail {
 
 	class AnyImpl {
 	public:
+
+		// Move construct the value into destination and return the new implementation
+		virtual AnyImpl* MoveTo(void* destination) = 0;
+
+		virtual const void* GetData() const = 0;
+		virtual size_t GetSize() const = 0;
+		virtual bool IsTriviallyCopyable() const = 0;
+
+		// Size of the implementation holding the value
+		virtual size_t GetImplSize() const = 0;
+
 		virtual ~AnyImpl() {}
 	};
 
@@ -83,6 +143,13 @@ namespace Detail {
 
 		DataType* Get();
 
+		AnyImpl* MoveTo(void* destination) override;
+
+		const void* GetData() const override;
+		size_t GetSize() const override;
+		bool IsTriviallyCopyable() const override;
+		size_t GetImplSize() const override;
+
 		// -Structors-
 
 		explicit AnyData(DataType data);
@@ -103,11 +170,11 @@ namespace Detail {
 template< typename CastType >
 bool TryCast(const Any& any, CastType** cast) {
 
-	if (any.Is<CastType>() == false) {
+	if (any.m_Type != TypeId::Get<CastType>()) {
 		return false;
 	}
 
-	*cast = dynamic_cast<Detail::AnyData<CastType>*>(any.m_Data.get())->Get();
+	*cast = static_cast<Detail::AnyData<CastType>*>(any.m_Data)->Get();
 	return true;
 }
 
@@ -116,7 +183,11 @@ bool TryCast(const Any& any, CastType** cast) {
 template< typename CastType >
 CastType* Cast(const Any& any) {
 
-	return dynamic_cast<Detail::AnyData<CastType>*>(any.m_Data.get())->Get();
+	if (any.m_Type != TypeId::Get<CastType>()) {
+		return nullptr;
+	}
+
+	return static_cast<Detail::AnyData<CastType>*>(any.m_Data)->Get();
 }
 
 // Set the any value
@@ -124,7 +195,9 @@ CastType* Cast(const Any& any) {
 template< typename NewType >
 void Any::Set(NewType type) {
 
-	m_Data.reset(new Detail::AnyData<NewType>(type));
+	Reset();
+	Emplace(std::move(type), std::integral_constant<bool, FitsInline<NewType>()>());
+	m_Type = TypeId::Get<NewType>();
 }
 
 template< typename Type >
@@ -136,28 +209,125 @@ Type* Any::Get() {
 // Determine if the inner value matches the ValueType
 template< typename ValueType >
 bool Any::Is() {
-	
-	return dynamic_cast<Detail::AnyData<ValueType>*>(m_Data.get()) != nullptr;
+
+	return m_Type == TypeId::Get<ValueType>();
+}
+
+inline TypeId Any::GetTypeId() const {
+
+	return m_Type;
+}
+
+inline bool Any::IsInline() const {
+
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(m_Data);
+	const unsigned char* buffer = reinterpret_cast<const unsigned char*>(&m_Buffer);
+	return data >= buffer && data < buffer + sizeof(m_Buffer);
+}
+
+inline const void* Any::GetData() const {
+
+	return m_Data != nullptr ? m_Data->GetData() : nullptr;
+}
+
+inline size_t Any::GetSize() const {
+
+	return m_Data != nullptr ? m_Data->GetSize() : 0;
+}
+
+inline bool Any::IsTriviallyCopyable() const {
+
+	return m_Data != nullptr && m_Data->IsTriviallyCopyable();
+}
+
+inline size_t Any::GetHeapSize() const {
+
+	return m_Data != nullptr && IsInline() == false ? m_Data->GetImplSize() : 0;
+}
+
+template< typename ValueType >
+constexpr bool Any::FitsInline() {
+
+	// The value must be movable without throwing since moving the Any relocates the inline value
+	return sizeof(Detail::AnyData<ValueType>) <= sizeof(m_Buffer)
+		&& alignof(Detail::AnyData<ValueType>) <= alignof(decltype(m_Buffer))
+		&& std::is_nothrow_move_constructible<ValueType>::value;
 }
 
 // Initialize to a value
 template< typename ValueType >
-Any::Any(ValueType value) {
-	
-	Set(value);
+Any::Any(ValueType value) : m_Data(nullptr) {
+
+	Set(std::move(value));
 }
 
 // Initialize to nothing, allowing for later setting
 inline Any::Any() : m_Data(nullptr) {}
 
-inline Any::Any(Any&& move) : m_Data(std::move(move.m_Data)) {}
+inline Any::~Any() {
+
+	Reset();
+}
+
+inline Any::Any(Any&& move) : m_Data(nullptr) {
+
+	Steal(move);
+}
 
 inline Any& Any::operator=(Any&& move) {
 
-	m_Data = std::move(move.m_Data);
+	if (this != &move) {
+		Reset();
+		Steal(move);
+	}
 	return *this;
 }
 
+inline void Any::Reset() {
+
+	if (m_Data == nullptr) {
+		return;
+	}
+
+	if (IsInline()) {
+		m_Data->~AnyImpl();
+	}
+	else {
+		delete m_Data;
+	}
+	m_Data = nullptr;
+	m_Type = TypeId();
+}
+
+inline void Any::Steal(Any& move) {
+
+	MIST_ASSERT(m_Data == nullptr);
+
+	if (move.IsInline()) {
+		m_Data = move.m_Data->MoveTo(&m_Buffer);
+		m_Type = move.m_Type;
+		move.Reset();
+	}
+	else {
+		m_Data = move.m_Data;
+		m_Type = move.m_Type;
+		move.m_Data = nullptr;
+		move.m_Type = TypeId();
+	}
+}
+
+template< typename NewType >
+void Any::Emplace(NewType&& value, std::true_type) {
+
+	m_Data = new (&m_Buffer) Detail::AnyData<NewType>(std::move(value));
+}
+
+template< typename NewType >
+void Any::Emplace(NewType&& value, std::false_type) {
+
+	m_Data = new Detail::AnyData<NewType>(std::move(value));
+}
+
 namespace Detail {
 
 	template< typename DataType >
@@ -167,7 +337,37 @@ namespace Detail {
 	}
 
 	template< typename DataType >
-	AnyData<DataType>::AnyData(DataType data) : m_Data(data) {}
+	AnyImpl* AnyData<DataType>::MoveTo(void* destination) {
+
+		return new (destination) AnyData<DataType>(std::move(m_Data));
+	}
+
+	template< typename DataType >
+	const void* AnyData<DataType>::GetData() const {
+
+		return &m_Data;
+	}
+
+	template< typename DataType >
+	size_t AnyData<DataType>::GetSize() const {
+
+		return sizeof(DataType);
+	}
+
+	template< typename DataType >
+	bool AnyData<DataType>::IsTriviallyCopyable() const {
+
+		return std::is_trivially_copyable<DataType>::value;
+	}
+
+	template< typename DataType >
+	size_t AnyData<DataType>::GetImplSize() const {
+
+		return sizeof(AnyData<DataType>);
+	}
+
+	template< typename DataType >
+	AnyData<DataType>::AnyData(DataType data) : m_Data(std::move(data)) {}
 
 }
 
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include "Delegate.h"
+#include "LayoutBuilder.h"
+#include "TypeId.h"
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+MIST_NAMESPACE
+
+namespace Detail {
+
+	// Write and read functions of a type that can't be copied bytewise
+	struct SerializationCodec {
+
+		// void(const void* object, std::vector<unsigned char>* output)
+		Delegate m_Write;
+
+		// bool(const unsigned char** cursor, const unsigned char* end, void* object)
+		Delegate m_Read;
+	};
+
+	// Determine if the layout is a single copy of the whole object of size bytes
+	inline bool IsContiguous(const Layout& layout, size_t size);
+}
+
+// BinarySerializer writes and reads reflected objects to and from a compact binary stream.
+// Every reflected member is written in offset order, recursing into members of reflected types.
+// The layout of a type is built once on first use and reused for every instance: runs of members that
+// can be copied bytewise are merged into a single memcpy, types that are fully covered by such a run
+// are copied whole, arrays of them included.
+// @Detail: Members that are neither reflected nor trivially copyable need a codec, std::string has a codec by default.
+// A type holding such a member without a codec asserts and is neither written nor read.
+// Values are written in the native byte order and pointers are written as their values.
+// Reading assigns into constructed objects. Layouts reference the type infos of the reflection, every nested type must be
+// registered (and materialized if deferred) before its first use. The serializer isn't thread safe, use one per thread.
+class BinarySerializer {
+
+public:
+
+	// -Public API-
+
+	// Append the serialized object to output
+	// @Detail: Returns false if the type can't be serialized, nothing is written
+	template< typename Type >
+	bool Write(const Type& object, std::vector<unsigned char>* output);
+
+	bool Write(TypeId type, const void* object, std::vector<unsigned char>* output);
+
+	// Read an object at cursor, the cursor is advanced past the object
+	// @Detail: Returns false if the stream ends before the object, the object is then partially read,
+	// or if the type can't be serialized
+	template< typename Type >
+	bool Read(const unsigned char** cursor, const unsigned char* end, Type* object);
+
+	bool Read(TypeId type, const unsigned char** cursor, const unsigned char* end, void* object);
+
+	// Append count contiguous objects to output, contiguous types are written with a single copy
+	template< typename Type >
+	bool WriteArray(const Type* objects, size_t count, std::vector<unsigned char>* output);
+
+	template< typename Type >
+	bool ReadArray(const unsigned char** cursor, const unsigned char* end, Type* objects, size_t count);
+
+	// Register the functions serializing a type that isn't reflected or trivially copyable
+	// @Detail: Codecs must be added before the first layout that uses the type is built
+	template< typename Type >
+	void AddCodec(void(*write)(const Type& object, std::vector<unsigned char>* output), bool(*read)(const unsigned char** cursor, const unsigned char* end, Type* object));
+
+	// Determine if objects of the type are serialized with a single copy
+	template< typename Type >
+	bool IsContiguous();
+
+	// -Structors-
+
+	explicit BinarySerializer(Reflection* reflection);
+
+	BinarySerializer(const BinarySerializer&) = delete;
+	BinarySerializer& operator=(const BinarySerializer&) = delete;
+
+private:
+
+	void WriteLayout(const Detail::Layout& layout, const unsigned char* object, std::vector<unsigned char>* output);
+	bool ReadLayout(const Detail::Layout& layout, const unsigned char** cursor, const unsigned char* end, unsigned char* object);
+
+	Detail::LayoutBuilder m_Layouts;
+	std::unordered_map<TypeId, std::unique_ptr<Detail::SerializationCodec>> m_Codecs;
+};
+
+
+// -Implementation-
+
+template< typename Type >
+bool BinarySerializer::Write(const Type& object, std::vector<unsigned char>* output) {
+
+	return Write(TypeId::Get<Type>(), &object, output);
+}
+
+template< typename Type >
+bool BinarySerializer::Read(const unsigned char** cursor, const unsigned char* end, Type* object) {
+
+	return Read(TypeId::Get<Type>(), cursor, end, object);
+}
+
+template< typename Type >
+bool BinarySerializer::WriteArray(const Type* objects, size_t count, std::vector<unsigned char>* output) {
+
+	MIST_ASSERT(objects != nullptr || count == 0);
+
+	const Detail::Layout* layout = m_Layouts.Get(TypeId::Get<Type>());
+	if (layout == nullptr) {
+		return false;
+	}
+
+	if (Detail::IsContiguous(*layout, sizeof(Type))) {
+		const unsigned char* begin = reinterpret_cast<const unsigned char*>(objects);
+		output->insert(output->end(), begin, begin + count * sizeof(Type));
+		return true;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		WriteLayout(*layout, reinterpret_cast<const unsigned char*>(objects + i), output);
+	}
+	return true;
+}
+
+template< typename Type >
+bool BinarySerializer::ReadArray(const unsigned char** cursor, const unsigned char* end, Type* objects, size_t count) {
+
+	MIST_ASSERT(objects != nullptr || count == 0);
+
+	const Detail::Layout* layout = m_Layouts.Get(TypeId::Get<Type>());
+	if (layout == nullptr) {
+		return false;
+	}
+
+	if (Detail::IsContiguous(*layout, sizeof(Type))) {
+		const size_t size = count * sizeof(Type);
+		if (static_cast<size_t>(end - *cursor) < size) {
+			return false;
+		}
+
+		if (size > 0) {
+			std::memcpy(objects, *cursor, size);
+		}
+		*cursor += size;
+		return true;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		if (ReadLayout(*layout, cursor, end, reinterpret_cast<unsigned char*>(objects + i)) == false) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template< typename Type >
+bool BinarySerializer::IsContiguous() {
+
+	const Detail::Layout* layout = m_Layouts.Get(TypeId::Get<Type>());
+	return layout != nullptr && Detail::IsContiguous(*layout, sizeof(Type));
+}
+
+template< typename Type >
+void BinarySerializer::AddCodec(void(*write)(const Type&, std::vector<unsigned char>*), bool(*read)(const unsigned char**, const unsigned char*, Type*)) {
+
+	MIST_ASSERT(write != nullptr && read != nullptr);
+
+	std::unique_ptr<Detail::SerializationCodec> codec(new Detail::SerializationCodec{
+		Delegate([write](const void* object, std::vector<unsigned char>* output) { write(*static_cast<const Type*>(object), output); }),
+		Delegate([read](const unsigned char** cursor, const unsigned char* end, void* object) { return read(cursor, end, static_cast<Type*>(object)); })
+	});
+	m_Layouts.AddCustom(TypeId::Get<Type>(), codec.get());
+	m_Codecs[TypeId::Get<Type>()] = std::move(codec);
+}
+
+namespace Detail {
+
+	inline bool IsContiguous(const Layout& layout, size_t size) {
+
+		return layout.m_Runs.size() == 1 && layout.m_Runs[0].m_Offset == 0 && layout.m_Runs[0].m_Size == size;
+	}
+}
+
+MIST_NAMESPACE_END
@@ -1,38 +1,156 @@
 #pragma once
 
 #include <Mist_Common/include/UtilityMacros.h>
-#include "Type.h"
-#include <tuple>
-#include <memory>
+#include "TypeId.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
 #include <utility>
 
+// Size in bytes of the inline buffer held by every Delegate.
+// Callables that fit in the buffer are stored without a heap allocation.
+#ifndef MIST_DELEGATE_BUFFER_SIZE
+#define MIST_DELEGATE_BUFFER_SIZE (sizeof(void*) * 3)
+#endif
+
 MIST_NAMESPACE
 
 namespace Detail {
-	class Callback;
+
+	// Storage for the callable held by a delegate, either inline or a pointer to the heap
+	union DelegateStorage {
+		void* m_Heap;
+		typename std::aligned_storage<MIST_DELEGATE_BUFFER_SIZE, alignof(void*)>::type m_Buffer;
+	};
+
+	enum class DelegateOperation {
+		Move,
+		Destroy
+	};
+
+	// Compile time list of types
+	template< typename... Types >
+	struct TypeList {};
+
+	// Prepend a type to a type list
+	template< typename Type, typename List >
+	struct PrependType;
+
+	template< typename Type, typename... Types >
+	struct PrependType<Type, TypeList<Types...>> {
+		using List = TypeList<Type, Types...>;
+	};
+
+	// Resolve the argument types of an invocation signature
+	// @Detail: Explicitly requested argument types are used as is, otherwise the types are deduced
+	// from the decayed types of the passed in arguments
+	template< typename ExplicitList, typename... Forwarded >
+	struct ArgumentList {
+		using List = ExplicitList;
+	};
+
+	template< typename... Forwarded >
+	struct ArgumentList<TypeList<>, Forwarded...> {
+		using List = TypeList<typename std::decay<Forwarded>::type...>;
+	};
+
+	// Determine how an argument of type Source is handed to a parameter declared as Target
+	// @Detail: The argument is passed through as a reference when it can bind to the parameter directly,
+	// which is every argument of the parameter type except lvalues for value and rvalue reference parameters.
+	// The remaining arguments are copied or converted once into a temporary of the parameter type.
+	template< typename Target, typename Source >
+	struct ForwardedArgument {
+
+		using TargetValue = typename std::remove_cv<typename std::remove_reference<Target>::type>::type;
+
+		static constexpr bool IS_DIRECT = std::is_same<typename std::decay<Source>::type, TargetValue>::value
+			&& (std::is_lvalue_reference<Target>::value || std::is_lvalue_reference<Source>::value == false);
+
+		using Type = typename std::conditional<IS_DIRECT, Source&&, TargetValue>::type;
+	};
+
+	// Forward an argument to a parameter declared as Target, see ForwardedArgument
+	template< typename Target, typename Source >
+	typename ForwardedArgument<Target, Source>::Type Forward(typename std::remove_reference<Source>::type& argument);
 }
 
+// A bound delegate is a handle to the method of a delegate with a signature that was validated when binding.
+// Calling the handle costs a single indirect call.
+// @Detail: The handle refers to the storage of the delegate, it is only valid for as long as the delegate is neither moved nor destroyed.
+template< typename ReturnType, typename... Arguments >
+class BoundDelegate {
+
+public:
+
+	// -Public API-
+
+	// Invoke the method, arguments are forwarded to the parameters of the method
+	template< typename... Forwarded >
+	ReturnType operator()(Forwarded&&... arguments) const;
+
+	// Determine if the handle refers to a method
+	bool IsValid() const;
+
+	// -Structors-
+
+	BoundDelegate() = default;
+
+private:
+
+	friend class Delegate;
+
+	using Invoker = ReturnType(*)(Detail::DelegateStorage*, Arguments&&...);
+
+	BoundDelegate(Detail::DelegateStorage* storage, Invoker invoker);
+
+	Detail::DelegateStorage* m_Storage = nullptr;
+	Invoker m_Invoker = nullptr;
+};
+
 // The delegate class is a generic wrapper around
 // a method of any signature. The method is then called using the invoke method.
 // The delegate class handles lambdas and global methods in a homogeneous interface.
 // @Detail: The signature of the invoke method must match the signature of the inner method.
+// Small callables are stored inline and invocation is a single call through a function pointer.
 class Delegate {
 
 public:
 
 	// -Public API-
 
-	template< typename ReturnType = void, typename... Arguments >
-	ReturnType Invoke(Arguments... arguments);
+	// Invoke the inner method, arguments are forwarded to the parameters of the method
+	// @Detail: The signature is ReturnType(Arguments...) when Arguments are given explicitly,
+	// otherwise the decayed types of the passed in arguments
+	template< typename ReturnType = void, typename... Arguments, typename... Forwarded >
+	ReturnType Invoke(Forwarded&&... arguments);
+
+	// Invoke the inner method with the ReturnType(Arguments...) signature given as a type list
+	template< typename ReturnType, typename... Arguments, typename... Forwarded >
+	ReturnType InvokeSignature(Detail::TypeList<Arguments...> signature, Forwarded&&... arguments);
 
 	template< typename ReturnType = void, typename... Arguments >
 	bool HasSignature() const;
 
+	// Validate the signature once and retrieve a handle that invokes the inner method directly
+	// @Detail: Returns an invalid handle if the signature doesn't match
+	template< typename ReturnType = void, typename... Arguments >
+	BoundDelegate<ReturnType, Arguments...> Bind();
+
+	// Retrieve the identity of the ReturnType(Arguments...) signature of the inner method
+	inline TypeId GetSignature() const;
+
+	// Determine if the callable is stored in the inline buffer rather than on the heap
+	inline bool IsInline() const;
+
+	// Retrieve the size of the callable allocated on the heap, 0 if the callable is inline
+	inline size_t GetHeapSize() const;
+
 	// -Structors-
 
 	template< typename CallbackType >
 	Delegate(CallbackType callback);
-	~Delegate() = default;
+	inline ~Delegate();
 
 	Delegate(const Delegate&) = delete;
 	Delegate& operator=(const Delegate&) = delete;
@@ -42,76 +160,106 @@ public:
 
 private:
 
-	std::unique_ptr<Detail::Callback> m_Callback;
+	// -Types-
+
+	// Invokers are stored type erased and cast back to ReturnType(*)(DelegateStorage*, Arguments&&...) when invoked
+	using ErasedInvoker = void(*)();
+	using Manager = void(*)(Detail::DelegateOperation operation, Detail::DelegateStorage* storage, Detail::DelegateStorage* destination);
+
+	// Destroy the held callable
+	inline void Reset();
+
+	// Take the callable held by move, leaving move empty
+	inline void Steal(Delegate& move);
+
+	TypeId m_Signature;
+	ErasedInvoker m_Invoker = nullptr;
+	Manager m_Manager = nullptr;
+	bool m_IsInline = false;
+
+	// Stored next to m_IsInline, the callable type is erased once constructed
+	uint32_t m_HeapSize = 0;
+	Detail::DelegateStorage m_Storage;
 };
 
 
 namespace Detail {
 
-	// @Detail: The series of callback, callbackInterface and callbackdefinition is a three tierd method to
-	// provide the correct call to a method that could be a lambda or a global function
+	// Determine if a callable is stored in the inline buffer of the delegate
+	// @Detail: The callable must be movable without throwing since moving the delegate relocates the inline callable
+	template< typename CallbackType >
+	using IsInlineCallback = std::integral_constant<bool, 
+		sizeof(CallbackType) <= sizeof(DelegateStorage)
+		&& alignof(CallbackType) <= alignof(DelegateStorage)
+		&& std::is_nothrow_move_constructible<CallbackType>::value>;
 
-	class Callback {
+	// Handles the placement of a callable within the delegate storage
+	template< typename CallbackType, bool IsInline = IsInlineCallback<CallbackType>::value >
+	struct CallbackStorage;
 
-	public:
+	template< typename CallbackType >
+	struct CallbackStorage<CallbackType, true> {
+
+		static CallbackType* Get(DelegateStorage* storage);
 
-		// -Structors-
+		static void Create(DelegateStorage* storage, CallbackType&& callback);
 
-		virtual ~Callback() = default;
+		static void Manage(DelegateOperation operation, DelegateStorage* storage, DelegateStorage* destination);
 	};
 
-	// The interface is the lowest the user will go in order to 
-	// call the method
-	template< typename ReturnType, typename... ArgumentTypes >
-	class CallbackInterface : public Callback {
+	template< typename CallbackType >
+	struct CallbackStorage<CallbackType, false> {
 
-	public:
-		// -Public API-
+		static CallbackType* Get(DelegateStorage* storage);
 
-		virtual ReturnType Invoke(ArgumentTypes... Arguments) = 0;
+		static void Create(DelegateStorage* storage, CallbackType&& callback);
 
-		// -Structors-
-		virtual ~CallbackInterface() override = default;
+		static void Manage(DelegateOperation operation, DelegateStorage* storage, DelegateStorage* destination);
 	};
 
-	template < typename CallbackType, typename ReturnType, typename... ArgumentTypes>
-	class CallbackDefinition : public CallbackInterface< ReturnType, ArgumentTypes... > {
+	// Calls the callable held in the delegate storage with the signature of the callable
+	template< typename CallbackType, typename ReturnType, typename... Arguments >
+	struct CallbackInvoker {
 
-	public:
-		ReturnType Invoke(ArgumentTypes... arguments) override;
+		static ReturnType Invoke(DelegateStorage* storage, Arguments&&... arguments);
+	};
+
+	// Deduce the ReturnType(Arguments...) signature of a callable
+	template< typename CallbackType >
+	struct CallbackSignature : CallbackSignature<decltype(&CallbackType::operator())> {};
+
+	template< typename ReturnType, typename... Arguments >
+	struct CallbackSignature<ReturnType(*)(Arguments...)> {
 
-		// -Structors-
-		explicit CallbackDefinition(CallbackType callback);
+		using Signature = ReturnType(Arguments...);
 
-	private:
-		CallbackType m_Callback;
+		template< typename CallbackType >
+		using Invoker = CallbackInvoker<CallbackType, ReturnType, Arguments...>;
 	};
 
-	// Construct a callback from the passed in object method
-	template< typename CallbackType, typename ReturnType, typename... Arguments >
-	Callback* MakeCallback(CallbackType&& callback, ReturnType(CallbackType::*callbackMethod)(Arguments...));
+	template< typename ClassType, typename ReturnType, typename... Arguments >
+	struct CallbackSignature<ReturnType(ClassType::*)(Arguments...)> : CallbackSignature<ReturnType(*)(Arguments...)> {};
 
-	// Construct a callback from the passed in object method
-	template< typename CallbackType, typename ReturnType, typename... Arguments >
-	Callback* MakeCallback(CallbackType&& callback, ReturnType(CallbackType::*callbackMethod)(Arguments...) const);
+	template< typename ClassType, typename ReturnType, typename... Arguments >
+	struct CallbackSignature<ReturnType(ClassType::*)(Arguments...) const> : CallbackSignature<ReturnType(*)(Arguments...)> {};
 
-	// Construct a callback from the passed in object
-	template< typename CallbackType,
-		// @Template Condition: Require that the callback type has a () operator for this call
-		typename TemplateCondition = decltype(&CallbackType::operator()) >
-		Callback* MakeCallback(CallbackType callback);
+	// Determine if the callback can't be invoked
+	template< typename CallbackType >
+	bool IsNullCallback(const CallbackType& callback);
 
-	// Construct a callback from the passed in global function
 	template< typename ReturnType, typename... Arguments >
-	Callback* MakeCallback(ReturnType(*callback)(Arguments...));
+	bool IsNullCallback(ReturnType(*callback)(Arguments...));
 
-	// Determine if a callback has the correct definition
+	// Invoke the bound method for every index in [begin, end), the i-th call receives the i-th element of every argument array
+	// @Detail: The i-th return value is written to results[i] if results isn't null
 	template< typename ReturnType, typename... Arguments >
-	bool HasDefinition(Callback* callback);
+	void InvokeBatch(const BoundDelegate<ReturnType, Arguments...>& bound, size_t begin, size_t end, ReturnType* results, const typename std::decay<Arguments>::type*... arguments);
 
-	// Cast the callback to the correct callback interface
 	template< typename ReturnType, typename... Arguments >
-	CallbackInterface<ReturnType, Arguments...>* Cast(Callback* callback);
+	void InvokeBatch(const BoundDelegate<ReturnType, Arguments...>& bound, size_t begin, size_t end, ReturnType* results, std::false_type isVoid, const typename std::decay<Arguments>::type*... arguments);
+
+	template< typename ReturnType, typename... Arguments >
+	void InvokeBatch(const BoundDelegate<ReturnType, Arguments...>& bound, size_t begin, size_t end, ReturnType* results, std::true_type isVoid, const typename std::decay<Arguments>::type*... arguments);
 }
 
 
@@ -121,91 +269,248 @@ namespace Detail {
 // -Delegate-
 
 // Invoke the inner callback
-template< typename ReturnType, typename... Arguments >
-ReturnType Delegate::Invoke(Arguments... arguments) {
+template< typename ReturnType, typename... Arguments, typename... Forwarded >
+ReturnType Delegate::Invoke(Forwarded&&... arguments) {
+
+	using Signature = typename Detail::ArgumentList<Detail::TypeList<Arguments...>, Forwarded...>::List;
+	return InvokeSignature<ReturnType>(Signature(), std::forward<Forwarded>(arguments)...);
+}
+
+template< typename ReturnType, typename... Arguments, typename... Forwarded >
+ReturnType Delegate::InvokeSignature(Detail::TypeList<Arguments...>, Forwarded&&... arguments) {
+
+	static_assert(sizeof...(Arguments) == sizeof...(Forwarded), "The argument count must match the signature");
 
 	// The object does not implement the correct method signature, call it with the correct types
-	MIST_ASSERT((Detail::HasDefinition<ReturnType, Arguments...>(m_Callback.get())));
+	MIST_ASSERT((HasSignature<ReturnType, Arguments...>()));
 
-	Detail::CallbackInterface<ReturnType, Arguments...>* interface = Detail::Cast<ReturnType, Arguments...>(m_Callback.get());
-	return interface->Invoke(arguments...);
+	using Invoker = ReturnType(*)(Detail::DelegateStorage*, Arguments&&...);
+	return reinterpret_cast<Invoker>(m_Invoker)(&m_Storage, Detail::Forward<Arguments, Forwarded>(arguments)...);
 }
 
 template< typename ReturnType, typename... Arguments >
 bool Delegate::HasSignature() const {
 
-	return Detail::HasDefinition<ReturnType, Arguments...>(m_Callback.get());
+	return m_Signature == TypeId::Get<ReturnType(Arguments...)>();
+}
+
+template< typename ReturnType, typename... Arguments >
+BoundDelegate<ReturnType, Arguments...> Delegate::Bind() {
+
+	if (HasSignature<ReturnType, Arguments...>() == false) {
+		return BoundDelegate<ReturnType, Arguments...>();
+	}
+
+	using Invoker = typename BoundDelegate<ReturnType, Arguments...>::Invoker;
+	return BoundDelegate<ReturnType, Arguments...>(&m_Storage, reinterpret_cast<Invoker>(m_Invoker));
+}
+
+TypeId Delegate::GetSignature() const {
+
+	return m_Signature;
+}
+
+bool Delegate::IsInline() const {
+
+	return m_IsInline;
 }
 
+size_t Delegate::GetHeapSize() const {
+
+	return m_HeapSize;
+}
 
 template< typename CallbackType >
-Delegate::Delegate(CallbackType callback) : m_Callback(Detail::MakeCallback(callback)) {
+Delegate::Delegate(CallbackType callback) {
+
+	MIST_ASSERT(Detail::IsNullCallback(callback) == false);
+
+	using Signature = Detail::CallbackSignature<CallbackType>;
+	using Storage = Detail::CallbackStorage<CallbackType>;
+
+	Storage::Create(&m_Storage, std::move(callback));
+	m_Signature = TypeId::Get<typename Signature::Signature>();
+	m_Invoker = reinterpret_cast<ErasedInvoker>(&Signature::template Invoker<CallbackType>::Invoke);
+	m_Manager = &Storage::Manage;
+	m_IsInline = Detail::IsInlineCallback<CallbackType>::value;
+	m_HeapSize = m_IsInline ? 0 : static_cast<uint32_t>(sizeof(CallbackType));
+}
+
+Delegate::~Delegate() {
+
+	Reset();
 }
 
 Delegate::Delegate(Delegate&& move) {
-	m_Callback = std::move(move.m_Callback);
+
+	Steal(move);
 }
 
 Delegate& Delegate::operator=(Delegate&& move) {
-	m_Callback = std::move(move.m_Callback);
+
+	if (this != &move) {
+		Reset();
+		Steal(move);
+	}
 	return *this;
 }
 
+void Delegate::Reset() {
+
+	if (m_Manager != nullptr) {
+		m_Manager(Detail::DelegateOperation::Destroy, &m_Storage, nullptr);
+	}
+
+	m_Signature = TypeId();
+	m_Invoker = nullptr;
+	m_Manager = nullptr;
+	m_IsInline = false;
+	m_HeapSize = 0;
+}
+
+void Delegate::Steal(Delegate& move) {
+
+	if (move.m_Manager != nullptr) {
+		move.m_Manager(Detail::DelegateOperation::Move, &move.m_Storage, &m_Storage);
+	}
+
+	m_Signature = move.m_Signature;
+	m_Invoker = move.m_Invoker;
+	m_Manager = move.m_Manager;
+	m_IsInline = move.m_IsInline;
+	m_HeapSize = move.m_HeapSize;
+
+	// The callable has been moved out, the source must not destroy it again
+	move.m_Manager = nullptr;
+	move.Reset();
+}
+
+
+// -BoundDelegate-
+
+template< typename ReturnType, typename... Arguments >
+template< typename... Forwarded >
+ReturnType BoundDelegate<ReturnType, Arguments...>::operator()(Forwarded&&... arguments) const {
+
+	static_assert(sizeof...(Arguments) == sizeof...(Forwarded), "The argument count must match the signature");
+
+	// The handle was default constructed or the signature didn't match when binding
+	MIST_ASSERT(IsValid());
+	return m_Invoker(m_Storage, Detail::Forward<Arguments, Forwarded>(arguments)...);
+}
+
+template< typename ReturnType, typename... Arguments >
+bool BoundDelegate<ReturnType, Arguments...>::IsValid() const {
+
+	return m_Invoker != nullptr;
+}
+
+template< typename ReturnType, typename... Arguments >
+BoundDelegate<ReturnType, Arguments...>::BoundDelegate(Detail::DelegateStorage* storage, Invoker invoker)
+	: m_Storage(storage)
+	, m_Invoker(invoker) {
+}
+
 
 namespace Detail {
 
-	template < typename CallbackType, typename ReturnType, typename... ArgumentTypes>
-	ReturnType CallbackDefinition<CallbackType, ReturnType, ArgumentTypes...>::Invoke(ArgumentTypes... arguments) {
+	template< typename CallbackType >
+	CallbackType* CallbackStorage<CallbackType, true>::Get(DelegateStorage* storage) {
 
-		return m_Callback(arguments...);
+		return reinterpret_cast<CallbackType*>(&storage->m_Buffer);
 	}
 
-	template < typename CallbackType, typename ReturnType, typename... ArgumentTypes>
-	CallbackDefinition<CallbackType, ReturnType, ArgumentTypes...>::CallbackDefinition(CallbackType callback) 
-		: m_Callback(callback) {
+	template< typename CallbackType >
+	void CallbackStorage<CallbackType, true>::Create(DelegateStorage* storage, CallbackType&& callback) {
+
+		new (&storage->m_Buffer) CallbackType(std::move(callback));
 	}
 
-	template< typename CallbackType,
-		// @Template Condition: Require that the callback type has a () operator for this call
-		typename TemplateCondition >
-	Callback* MakeCallback(CallbackType callback) {
+	template< typename CallbackType >
+	void CallbackStorage<CallbackType, true>::Manage(DelegateOperation operation, DelegateStorage* storage, DelegateStorage* destination) {
 
-		return MakeCallback(std::forward<CallbackType>(callback), &CallbackType::operator());
+		CallbackType* callback = Get(storage);
+		if (operation == DelegateOperation::Move) {
+			new (&destination->m_Buffer) CallbackType(std::move(*callback));
+		}
+		callback->~CallbackType();
 	}
-	
-	template< typename CallbackType, typename ReturnType, typename... Arguments >
-	Callback* MakeCallback(CallbackType&& callback, ReturnType(CallbackType::*)(Arguments...)) {
 
-		return new CallbackDefinition<CallbackType, ReturnType, Arguments...>(std::forward<CallbackType>(callback));
+	template< typename CallbackType >
+	CallbackType* CallbackStorage<CallbackType, false>::Get(DelegateStorage* storage) {
+
+		return static_cast<CallbackType*>(storage->m_Heap);
+	}
+
+	template< typename CallbackType >
+	void CallbackStorage<CallbackType, false>::Create(DelegateStorage* storage, CallbackType&& callback) {
+
+		storage->m_Heap = new CallbackType(std::move(callback));
+	}
+
+	template< typename CallbackType >
+	void CallbackStorage<CallbackType, false>::Manage(DelegateOperation operation, DelegateStorage* storage, DelegateStorage* destination) {
+
+		if (operation == DelegateOperation::Move) {
+			destination->m_Heap = storage->m_Heap;
+		}
+		else {
+			delete Get(storage);
+		}
+		storage->m_Heap = nullptr;
 	}
 
 	template< typename CallbackType, typename ReturnType, typename... Arguments >
-	Callback* MakeCallback(CallbackType&& callback, ReturnType(CallbackType::*)(Arguments...) const) {
+	ReturnType CallbackInvoker<CallbackType, ReturnType, Arguments...>::Invoke(DelegateStorage* storage, Arguments&&... arguments) {
+
+		return (*CallbackStorage<CallbackType>::Get(storage))(std::forward<Arguments>(arguments)...);
+	}
+
+	template< typename Target, typename Source >
+	typename ForwardedArgument<Target, Source>::Type Forward(typename std::remove_reference<Source>::type& argument) {
 
-		return new CallbackDefinition<CallbackType, ReturnType, Arguments...>(std::forward<CallbackType>(callback));
+		return static_cast<Source&&>(argument);
+	}
+
+	template< typename CallbackType >
+	bool IsNullCallback(const CallbackType&) {
+
+		return false;
 	}
 
 	template< typename ReturnType, typename... Arguments >
-	Callback* MakeCallback(ReturnType(*callback)(Arguments...)) {
-		
-		MIST_ASSERT(callback != nullptr);
-		return new CallbackDefinition<ReturnType(*)(Arguments...), ReturnType, Arguments...>(callback);
+	bool IsNullCallback(ReturnType(*callback)(Arguments...)) {
+
+		return callback == nullptr;
 	}
 
-	// Determine if a callback has the correct definition
 	template< typename ReturnType, typename... Arguments >
-	bool HasDefinition(Callback* callback) {
+	void InvokeBatch(const BoundDelegate<ReturnType, Arguments...>& bound, size_t begin, size_t end, ReturnType* results, const typename std::decay<Arguments>::type*... arguments) {
+
+		InvokeBatch(bound, begin, end, results, std::is_void<ReturnType>(), arguments...);
+	}
 
-		MIST_ASSERT(callback != nullptr);
-		return dynamic_cast<CallbackInterface<ReturnType, Arguments...>*>(callback) != nullptr;
+	template< typename ReturnType, typename... Arguments >
+	void InvokeBatch(const BoundDelegate<ReturnType, Arguments...>& bound, size_t begin, size_t end, ReturnType* results, std::false_type, const typename std::decay<Arguments>::type*... arguments) {
+
+		if (results == nullptr) {
+			for (size_t i = begin; i < end; ++i) {
+				bound(arguments[i]...);
+			}
+			return;
+		}
+
+		for (size_t i = begin; i < end; ++i) {
+			results[i] = bound(arguments[i]...);
+		}
 	}
 
-	// Cast the callback to the correct callback interface
 	template< typename ReturnType, typename... Arguments >
-	CallbackInterface<ReturnType, Arguments...>* Cast(Callback* callback) {
+	void InvokeBatch(const BoundDelegate<ReturnType, Arguments...>& bound, size_t begin, size_t end, ReturnType*, std::true_type, const typename std::decay<Arguments>::type*... arguments) {
 
-		MIST_ASSERT(callback != nullptr);
-		return dynamic_cast<CallbackInterface<ReturnType, Arguments...>*>(callback);
+		for (size_t i = begin; i < end; ++i) {
+			bound(arguments[i]...);
+		}
 	}
 
 }
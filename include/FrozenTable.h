@@ -0,0 +1,109 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include "../Mist_hashing/include/HashID.h"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+MIST_NAMESPACE
+
+namespace Detail {
+
+	// Immutable lookup table built from a registration map.
+	// Keys are kept sorted in one contiguous array and searched with a binary search,
+	// values are referenced in place so pointers retrieved before freezing stay valid.
+	// @Detail: Only the search is contiguous, every hit still follows a pointer into the node of the map.
+	// Copying the values into the table would move infos that callers and other infos already point to.
+	// The map must not be modified after building the table
+	template< typename ValueType >
+	class FrozenTable {
+
+	public:
+
+		// -Public API-
+
+		// Build the table from a map of hash id values to values, replaces the previous table
+		template< typename MapType >
+		void Build(MapType& map);
+
+		// Retrieve the value at key, null if the key isn't in the table
+		ValueType* Find(HashID::ValueType key) const;
+
+		bool IsBuilt() const;
+
+		size_t Size() const;
+
+		// Retrieve the size of the sorted keys and values allocated on the heap
+		size_t GetHeapSize() const;
+
+		// -Structors-
+
+		FrozenTable() : m_IsBuilt(false) {}
+
+	private:
+
+		std::vector<HashID::ValueType> m_Keys;
+		std::vector<ValueType*> m_Values;
+		bool m_IsBuilt;
+	};
+
+
+	// -Implementation-
+
+	template< typename ValueType >
+	template< typename MapType >
+	void FrozenTable<ValueType>::Build(MapType& map) {
+
+		std::vector<std::pair<HashID::ValueType, ValueType*>> entries;
+		entries.reserve(map.size());
+		for (auto& entry : map) {
+			entries.emplace_back(entry.first, &entry.second);
+		}
+
+		std::sort(entries.begin(), entries.end(),
+			[](const std::pair<HashID::ValueType, ValueType*>& left, const std::pair<HashID::ValueType, ValueType*>& right) { return left.first < right.first; });
+
+		m_Keys.clear();
+		m_Values.clear();
+		m_Keys.reserve(entries.size());
+		m_Values.reserve(entries.size());
+		for (const auto& entry : entries) {
+			m_Keys.push_back(entry.first);
+			m_Values.push_back(entry.second);
+		}
+		m_IsBuilt = true;
+	}
+
+	template< typename ValueType >
+	ValueType* FrozenTable<ValueType>::Find(HashID::ValueType key) const {
+
+		auto found = std::lower_bound(m_Keys.begin(), m_Keys.end(), key);
+		if (found == m_Keys.end() || *found != key) {
+			return nullptr;
+		}
+		return m_Values[found - m_Keys.begin()];
+	}
+
+	template< typename ValueType >
+	bool FrozenTable<ValueType>::IsBuilt() const {
+
+		return m_IsBuilt;
+	}
+
+	template< typename ValueType >
+	size_t FrozenTable<ValueType>::Size() const {
+
+		return m_Keys.size();
+	}
+
+	template< typename ValueType >
+	size_t FrozenTable<ValueType>::GetHeapSize() const {
+
+		return m_Keys.capacity() * sizeof(HashID::ValueType) + m_Values.capacity() * sizeof(ValueType*);
+	}
+
+}
+
+MIST_NAMESPACE_END
@@ -3,6 +3,8 @@
 #include <Mist_Common/include/UtilityMacros.h>
 #include "Delegate.h"
 #include "MetaData.h"
+#include "Parallel.h"
+#include <cstddef>
 
 MIST_NAMESPACE
 
@@ -13,11 +15,34 @@ public:
 
 	// -Public API-
 
+	// Invoke the function, arguments are forwarded to the function
+	// @Detail: The signature is deduced from the decayed argument types unless Arguments are given explicitly
+	template< typename ReturnType, typename... Arguments, typename... Forwarded >
+	ReturnType Invoke(Forwarded&&... arguments);
+
+	// Validate the function signature once and retrieve a handle that invokes the function directly
+	// @Detail: The handle is only valid for as long as the GlobalFunction isn't moved or destroyed,
+	// an invalid handle is returned if the signature doesn't match
+	template< typename ReturnType, typename... Arguments >
+	BoundDelegate<ReturnType, Arguments...> Bind();
+
+	// Invoke the function count times, the i-th call receives the i-th element of every argument array
+	// @Detail: The signature is validated once for the whole batch,
+	// the i-th return value is written to results[i] if results isn't null.
+	// The arrays hold the decayed parameter types, a const std::string& parameter reads from a std::string array
 	template< typename ReturnType, typename... Arguments >
-	ReturnType Invoke(Arguments... arguments);
+	void InvokeBatch(size_t count, ReturnType* results, const typename std::decay<Arguments>::type*... arguments);
+
+	// Invoke the function count times, splitting the calls in threadCount chunks run by the worker pool
+	// @Detail: A thread count of 0 uses the hardware concurrency, the function must be safe to call concurrently
+	template< typename ReturnType, typename... Arguments >
+	void InvokeBatchParallel(size_t threadCount, size_t count, ReturnType* results, const typename std::decay<Arguments>::type*... arguments);
 
 	inline MetaData* GetMetaData();
 
+	// Add the size of the global function, its callable and its meta data to stats
+	inline void AddMemoryStats(MemoryStats* stats) const;
+
 	// -Structors-
 
 	template< typename FunctionType >
@@ -32,10 +57,36 @@ private:
 
 // -Implementation-
 
+template< typename ReturnType, typename... Arguments, typename... Forwarded >
+ReturnType GlobalFunction::Invoke(Forwarded&&... arguments) {
+
+	return m_Function.Invoke<ReturnType, Arguments...>(std::forward<Forwarded>(arguments)...);
+}
+
+template< typename ReturnType, typename... Arguments >
+BoundDelegate<ReturnType, Arguments...> GlobalFunction::Bind() {
+
+	return m_Function.Bind<ReturnType, Arguments...>();
+}
+
 template< typename ReturnType, typename... Arguments >
-ReturnType GlobalFunction::Invoke(Arguments... arguments) {
+void GlobalFunction::InvokeBatch(size_t count, ReturnType* results, const typename std::decay<Arguments>::type*... arguments) {
+
+	BoundDelegate<ReturnType, Arguments...> bound = Bind<ReturnType, Arguments...>();
+	MIST_ASSERT(bound.IsValid());
 
-	return m_Function.Invoke<ReturnType, Arguments...>(arguments...);
+	Detail::InvokeBatch(bound, 0, count, results, arguments...);
+}
+
+template< typename ReturnType, typename... Arguments >
+void GlobalFunction::InvokeBatchParallel(size_t threadCount, size_t count, ReturnType* results, const typename std::decay<Arguments>::type*... arguments) {
+
+	BoundDelegate<ReturnType, Arguments...> bound = Bind<ReturnType, Arguments...>();
+	MIST_ASSERT(bound.IsValid());
+
+	Detail::ParallelFor(count, threadCount, [&](size_t begin, size_t end) {
+		Detail::InvokeBatch(bound, begin, end, results, arguments...);
+	});
 }
 
 inline MetaData* GlobalFunction::GetMetaData() {
@@ -43,6 +94,14 @@ inline MetaData* GlobalFunction::GetMetaData() {
 	return &m_MetaData;
 }
 
+inline void GlobalFunction::AddMemoryStats(MemoryStats* stats) const {
+
+	stats->m_GlobalBytes += sizeof(GlobalFunction);
+	stats->m_DelegateBytes += m_Function.GetHeapSize();
+	++stats->m_GlobalCount;
+	m_MetaData.AddMemoryStats(stats);
+}
+
 // -Structors-
 
 template< typename FunctionType >
@@ -18,6 +18,9 @@ public:
 
 	inline MetaData* GetMetaData();
 
+	// Add the size of the global object and its meta data to stats
+	inline void AddMemoryStats(MemoryStats* stats) const;
+
 	// -Structors-
 
 	template< typename ObjectType >
@@ -46,6 +49,14 @@ inline MetaData* GlobalObject::GetMetaData() {
 	return &m_MetaData;
 }
 
+inline void GlobalObject::AddMemoryStats(MemoryStats* stats) const {
+
+	stats->m_GlobalBytes += sizeof(GlobalObject);
+	stats->m_AnyBytes += m_Global.GetHeapSize();
+	++stats->m_GlobalCount;
+	m_MetaData.AddMemoryStats(stats);
+}
+
 // -Structors-
 
 template< typename ObjectType >
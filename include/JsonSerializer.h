@@ -0,0 +1,241 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include "../Mist_hashing/include/HashID.h"
+#include "Delegate.h"
+#include "TypeId.h"
+#include "TypeIndex.h"
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+MIST_NAMESPACE
+
+namespace Detail {
+
+	struct JsonPlan;
+
+	// Reflected member written as a JSON field
+	struct JsonField {
+
+		enum class Kind {
+			Bool,
+			Signed,
+			Unsigned,
+			Float,
+			Double,
+			String,
+			Object
+		};
+
+		const char* m_Name;
+		HashID::ValueType m_Key;
+		Kind m_Kind;
+		size_t m_Size;
+		MemberInfo* m_Member;
+
+		// Plan of the member's type for object fields
+		const JsonPlan* m_Plan;
+	};
+
+	// Fields of a type in the order they are written, along with their keys sorted for lookups while parsing
+	struct JsonPlan {
+		std::vector<JsonField> m_Fields;
+		std::vector<HashID::ValueType> m_Keys;
+		std::vector<const JsonField*> m_KeyFields;
+	};
+}
+
+// JsonSerializer writes reflected objects as JSON and reads them back through a JsonReader.
+// Every named member is a field, members of reflected types are nested objects. Booleans, integers,
+// floating point values and std::string are supported as values.
+// @Detail: Only members registered with TypeInfo::AddNamedMember keep their names, members registered with a HashID
+// are skipped. Types with a named member of an unsupported type can't be written or read.
+// Plans reference the type infos of the reflection, every nested type must be registered (and materialized if deferred)
+// before its first use. The serializer isn't thread safe, use one per thread.
+class JsonSerializer {
+
+public:
+
+	// -Public API-
+
+	// Write the object to the stream as JSON, the output is buffered and written in large blocks.
+	// Returns false without writing anything if the type can't be written
+	template< typename Type >
+	bool Write(const Type& object, std::ostream& stream);
+
+	bool Write(TypeId type, const void* object, std::ostream& stream);
+
+	// Read the object from the stream in fixed size chunks, see JsonReader
+	template< typename Type >
+	bool Read(std::istream& stream, Type* object);
+
+	bool Read(TypeId type, std::istream& stream, void* object);
+
+	// -Structors-
+
+	explicit JsonSerializer(Reflection* reflection);
+
+	JsonSerializer(const JsonSerializer&) = delete;
+	JsonSerializer& operator=(const JsonSerializer&) = delete;
+
+private:
+
+	friend class JsonReader;
+
+	// Retrieve the plan of a reflected type, building it on first use. Null if the type or one of its named members
+	// isn't supported
+	const Detail::JsonPlan* GetPlan(TypeId type);
+
+	void WriteObject(const Detail::JsonPlan& plan, const unsigned char* object, std::string* buffer, std::ostream& stream);
+
+	Detail::TypeIndex m_TypeIndex;
+	std::unordered_map<TypeId, std::unique_ptr<Detail::JsonPlan>> m_Plans;
+};
+
+// JsonReader parses JSON pushed in chunks of any size and writes values straight into the fields of reflected objects.
+// No document is built: keys are resolved through their HashID as they're parsed and only the token being parsed
+// is buffered, keeping memory constant whatever the size of the input.
+// @Detail: Fields missing from the input keep their value and unknown fields are skipped, null values are ignored.
+// Reading stops at the first malformed or mismatched value.
+class JsonReader {
+
+public:
+
+	// -Public API-
+
+	// Start reading a JSON object into object, the reader is in error if the type can't be read
+	template< typename Type >
+	void Begin(Type* object);
+
+	void Begin(TypeId type, void* object);
+
+	// Start reading a JSON array of objects, every element is read into element and onElement is invoked once it's complete
+	// @Detail: Fields missing from an element keep the value of the previous element
+	template< typename Type, typename CallbackType >
+	void BeginArray(Type* element, CallbackType onElement);
+
+	void BeginArray(TypeId type, void* element, Delegate onElement);
+
+	// Parse the next chunk of input, returns false once the input is malformed
+	bool Feed(const char* data, size_t size);
+
+	// Determine if the input was a complete document
+	bool Finish();
+
+	bool HasError() const;
+
+	// Retrieve the number of bytes parsed, the location of the error if there is one
+	size_t GetPosition() const;
+
+	// -Structors-
+
+	explicit JsonReader(JsonSerializer* serializer);
+
+	JsonReader(const JsonReader&) = delete;
+	JsonReader& operator=(const JsonReader&) = delete;
+
+private:
+
+	// -Types-
+
+	enum class State {
+		Value,
+		ValueOrEnd,
+		KeyOrEnd,
+		Key,
+		Colon,
+		CommaOrEnd,
+		String,
+		Number,
+		Literal,
+		Done,
+		Error
+	};
+
+	// What the next value is parsed into
+	enum class Target {
+		Root,
+		Element,
+		Field,
+		Skip
+	};
+
+	struct Frame {
+		const Detail::JsonPlan* m_Plan;
+		unsigned char* m_Object;
+		bool m_IsArray;
+
+		// The frame is the top level array, its elements are read into m_Object
+		bool m_IsRootArray;
+
+		// The frame is an element of the top level array
+		bool m_IsElement;
+	};
+
+	void Reset(TypeId type, void* object, bool isArray);
+
+	bool ProcessCharacter(char character);
+	bool BeginValue(char character);
+	bool PushFrame(const Detail::JsonPlan* plan, unsigned char* object, bool isArray, bool isRootArray, bool isElement);
+	void PopFrame();
+	void CompleteValue();
+
+	bool CompleteString();
+	bool CompleteNumber();
+	bool CompleteLiteral();
+
+	JsonSerializer* m_Serializer;
+	State m_State;
+	size_t m_Position;
+
+	std::vector<Frame> m_Frames;
+
+	Target m_Target;
+	const Detail::JsonField* m_Field;
+	unsigned char* m_FieldAddress;
+
+	const Detail::JsonPlan* m_RootPlan;
+	unsigned char* m_RootObject;
+	bool m_IsArray;
+	Delegate m_OnElement;
+
+	// Characters of the token being parsed, tokens may span chunks
+	std::string m_Token;
+	bool m_IsKey;
+	bool m_IsEscaping;
+	bool m_HasEscapes;
+};
+
+
+// -Implementation-
+
+template< typename Type >
+bool JsonSerializer::Write(const Type& object, std::ostream& stream) {
+
+	return Write(TypeId::Get<Type>(), &object, stream);
+}
+
+template< typename Type >
+bool JsonSerializer::Read(std::istream& stream, Type* object) {
+
+	return Read(TypeId::Get<Type>(), stream, object);
+}
+
+template< typename Type >
+void JsonReader::Begin(Type* object) {
+
+	Begin(TypeId::Get<Type>(), object);
+}
+
+template< typename Type, typename CallbackType >
+void JsonReader::BeginArray(Type* element, CallbackType onElement) {
+
+	BeginArray(TypeId::Get<Type>(), element, Delegate(std::move(onElement)));
+}
+
+MIST_NAMESPACE_END
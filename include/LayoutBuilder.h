@@ -0,0 +1,131 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include "TypeId.h"
+#include "TypeIndex.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+MIST_NAMESPACE
+
+namespace Detail {
+
+	struct Layout;
+
+	// Leaf of a layout, the value at m_Offset bytes into the laid out object
+	struct LayoutField {
+
+		enum class Kind {
+			// m_Size bytes handled bytewise
+			Bytes,
+			// Value of type m_Type handled by the custom functions registered for the type
+			Custom,
+			// Member resolved through its member pointer and handled with the layout of its type
+			Member
+		};
+
+		Kind m_Kind;
+		size_t m_Offset;
+		size_t m_Size;
+		TypeId m_Type;
+
+		// Functions registered for the type of custom fields, see LayoutBuilder::AddCustom
+		void* m_Custom;
+		MemberInfo* m_Member;
+		const Layout* m_Layout;
+	};
+
+	// Adjacent fields handled at once
+	// @Detail: Runs of adjacent bytes fields have the size of the run, other fields have a run of their own with no bytes
+	struct LayoutRun {
+		size_t m_Offset;
+		size_t m_Size;
+		uint32_t m_FirstField;
+		uint32_t m_FieldCount;
+	};
+
+	// Reflected members of a type in offset order, members without an offset follow in name order.
+	// Nested members with a byte offset are flattened into the fields of their holder
+	struct Layout {
+		std::vector<LayoutField> m_Fields;
+		std::vector<LayoutRun> m_Runs;
+	};
+
+	// Builds the layout of a type once on first use and keeps it for the following lookups, shared by the
+	// object walkers of the library. Members that are neither reflected nor custom are handled bytewise
+	// and must be free of padding so that only the bits of values are compared, copies may include padding.
+	// @Detail: A type holding a member that can't be laid out asserts and has no layout.
+	// Layouts reference the type infos of the reflection, every nested type must be registered
+	// (and materialized if deferred) before its first use
+	class LayoutBuilder {
+
+	public:
+
+		// -Types-
+
+		// Requirement on the members handled bytewise
+		enum class Bytewise {
+			// Every byte is part of the value, for walkers comparing bytes
+			PaddingFree,
+			// The member can be copied bytewise, for walkers copying bytes
+			TriviallyCopyable
+		};
+
+		// -Public API-
+
+		// Retrieve the layout of a type, null if the type or one of its members can't be laid out
+		const Layout* Get(TypeId type);
+
+		// Register the functions handling a type as a single custom field, functions are owned by the caller
+		// @Detail: Functions must be added before the first layout that uses the type is built
+		void AddCustom(TypeId type, void* functions);
+
+		// Determine if the layout of a type has been built
+		inline bool IsBuilt(TypeId type) const;
+
+		// -Structors-
+
+		explicit LayoutBuilder(Reflection* reflection, Bytewise bytewise = Bytewise::PaddingFree);
+
+		LayoutBuilder(const LayoutBuilder&) = delete;
+		LayoutBuilder& operator=(const LayoutBuilder&) = delete;
+
+	private:
+
+		// Retrieve the layout of a member's type, members of types that aren't reflected get a single bytes field
+		const Layout* GetMemberLayout(const MemberInfo& member);
+
+		// Determine if member can be handled bytewise
+		inline bool IsBytewise(const MemberInfo& member) const;
+
+		// Append the fields of member at offset bytes into the laid out object, returns false if the member can't be laid out
+		bool AddMemberFields(MemberInfo* member, size_t offset, std::vector<LayoutField>* fields);
+
+		TypeIndex m_TypeIndex;
+		std::unordered_map<TypeId, std::unique_ptr<Layout>> m_Layouts;
+		std::unordered_map<TypeId, void*> m_Customs;
+		Bytewise m_Bytewise;
+
+		// Layout of the last type looked up, objects of a single type are usually walked in bulk
+		TypeId m_LastType;
+		const Layout* m_LastLayout;
+	};
+
+
+	// -Implementation-
+
+	inline bool LayoutBuilder::IsBuilt(TypeId type) const {
+
+		return m_Layouts.find(type) != m_Layouts.end();
+	}
+
+	inline bool LayoutBuilder::IsBytewise(const MemberInfo& member) const {
+
+		return m_Bytewise == Bytewise::PaddingFree ? member.IsPaddingFree() : member.IsTriviallyCopyable();
+	}
+}
+
+MIST_NAMESPACE_END
@@ -2,12 +2,25 @@
 
 #include <Mist_Common/include/UtilityMacros.h>
 #include "MetaData.h"
-#include "Delegate.h"
+#include "TypeId.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Determine if every bit of a class type takes part in its value, classes are otherwise assumed to hold padding
+#if (defined(__clang__) && __clang_major__ >= 6) || (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 7) || (defined(_MSC_VER) && _MSC_VER >= 1911)
+#define MIST_HAS_UNIQUE_OBJECT_REPRESENTATIONS(Type) __has_unique_object_representations(Type)
+#else
+#define MIST_HAS_UNIQUE_OBJECT_REPRESENTATIONS(Type) false
+#endif
 
 MIST_NAMESPACE
 
 // Member info holds a reference to a member in a class allowing
 // to be queried from any object
+// @Detail: Members of standard layout classes are addressed through their byte offset,
+// other members are resolved through the member pointer.
 class MemberInfo {
 
 public:
@@ -19,6 +32,62 @@ public:
 
 	inline MetaData* GetMetaData();
 
+	// Retrieve the name the member was registered with, null if it was registered with a HashID
+	inline const char* GetName() const;
+
+	// -Layout-
+
+	// Determine if the member can be addressed through its byte offset
+	inline bool HasOffset() const;
+
+	// Retrieve the address of the member within object using the byte offset
+	// @Detail: Requires HasOffset, the object must be of the class the member was registered from
+	inline void* GetAddress(void* object) const;
+	inline const void* GetAddress(const void* object) const;
+
+	// Retrieve the address of the member within object, through the byte offset when possible and the member pointer otherwise
+	// @Detail: The object must be of the class the member was registered from
+	inline void* Resolve(void* object);
+	inline const void* Resolve(const void* object);
+
+	inline size_t GetOffset() const;
+	inline size_t GetSize() const;
+	inline size_t GetAlignment() const;
+
+	// Determine if the member can be copied bytewise
+	inline bool IsTriviallyCopyable() const;
+
+	// Determine if every byte of the member is part of its value, such members can be compared bytewise
+	// @Detail: Floating point members are compared by their bits, see Detail::IsPaddingFree
+	inline bool IsPaddingFree() const;
+
+	// Retrieve the identity of the member's type and of the class holding it
+	inline TypeId GetTypeId() const;
+	inline TypeId GetClassTypeId() const;
+
+	// Add the size of the member info and its meta data to stats
+	inline void AddMemoryStats(MemoryStats* stats) const;
+
+	// -Batch-
+
+	// Copy the member of every object into the contiguous output
+	template< typename MemberType, typename ClassType >
+	void Gather(ClassType* const* objects, size_t count, MemberType* output);
+
+	// Copy the member of count objects laid out stride bytes apart, starting at first, into the contiguous output
+	// @Detail: Requires HasOffset, use a stride of sizeof(ClassType) for an array of objects
+	template< typename MemberType >
+	void GatherStrided(const void* first, size_t stride, size_t count, MemberType* output) const;
+
+	// Write the contiguous input into the member of every object
+	template< typename MemberType, typename ClassType >
+	void Scatter(ClassType* const* objects, size_t count, const MemberType* input);
+
+	// Write the contiguous input into the member of count objects laid out stride bytes apart, starting at first
+	// @Detail: Requires HasOffset, use a stride of sizeof(ClassType) for an array of objects
+	template< typename MemberType >
+	void ScatterStrided(void* first, size_t stride, size_t count, const MemberType* input) const;
+
 	// -Types-
 
 	template< typename ClassType, typename MemberType >
@@ -37,11 +106,68 @@ public:
 
 private:
 
+	friend class TypeInfo;
+
+	// Resolve the member of object through the member pointer stored at memberPointer
+	template< typename ClassType, typename MemberType >
+	static void* ResolveMemberPointer(const void* memberPointer, void* object);
+
 	MetaData m_MetaData;
-	Delegate m_MemberRetrieval;
+
+	// Members with a byte offset only keep the offset, other members keep their member pointer
+	union {
+		size_t m_Offset;
+		typename std::aligned_storage<sizeof(void*) * 2, alignof(void*)>::type m_MemberPointer;
+	};
+
+	// Null for members with a byte offset
+	void*(*m_ResolveMemberPointer)(const void* memberPointer, void* object);
+
+	TypeId m_TypeId;
+	TypeId m_ClassTypeId;
+	const char* m_Name;
+	uint32_t m_Size;
+	uint32_t m_Alignment;
+	bool m_IsTriviallyCopyable;
+	bool m_IsPaddingFree;
 };
 
 
+namespace Detail {
+
+	// Determine if a type has no padding bits: scalars other than long double and arrays of such types,
+	// class types when the compiler can tell that every bit of the class takes part in its value
+	template< typename Type >
+	struct IsPaddingFree : std::integral_constant<bool, (std::is_scalar<Type>::value
+		&& std::is_same<typename std::remove_cv<Type>::type, long double>::value == false
+		&& std::is_null_pointer<Type>::value == false) || MIST_HAS_UNIQUE_OBJECT_REPRESENTATIONS(Type)> {};
+
+	template< typename Type, size_t Count >
+	struct IsPaddingFree<Type[Count]> : IsPaddingFree<Type> {};
+
+	// Compute the byte offset of a member within its class
+	// @Detail: The class must be standard layout, the member is resolved against uninitialized storage
+	// without constructing an instance of the class
+	template< typename ClassType, typename MemberType >
+	size_t MemberOffset(MemberType ClassType::* memberPointer);
+
+	// Copy count values laid out stride bytes apart into the contiguous output
+	// @Detail: Trivially copyable values are copied bytewise which keeps the loop free of calls and vectorizable
+	template< typename MemberType >
+	void CopyStrided(const unsigned char* source, size_t stride, size_t count, MemberType* output, std::true_type isTriviallyCopyable);
+
+	template< typename MemberType >
+	void CopyStrided(const unsigned char* source, size_t stride, size_t count, MemberType* output, std::false_type isTriviallyCopyable);
+
+	// Copy the contiguous input into count values laid out stride bytes apart
+	template< typename MemberType >
+	void WriteStrided(unsigned char* destination, size_t stride, size_t count, const MemberType* input, std::true_type isTriviallyCopyable);
+
+	template< typename MemberType >
+	void WriteStrided(unsigned char* destination, size_t stride, size_t count, const MemberType* input, std::false_type isTriviallyCopyable);
+}
+
+
 // -Implementation-
 
 template< typename MemberType, typename ClassType >
@@ -49,7 +175,10 @@ MemberType* MemberInfo::Get(ClassType* object) {
 
 	MIST_ASSERT(object != nullptr);
 
-	return m_MemberRetrieval.Invoke<MemberType*, ClassType*>(object);
+	// The requested types must match the registered member exactly
+	MIST_ASSERT(m_TypeId == TypeId::Get<MemberType>());
+	MIST_ASSERT(m_ClassTypeId == TypeId::Get<ClassType>());
+	return static_cast<MemberType*>(Resolve(static_cast<void*>(object)));
 }
 
 inline MetaData* MemberInfo::GetMetaData() {
@@ -57,21 +186,271 @@ inline MetaData* MemberInfo::GetMetaData() {
 	return &m_MetaData;
 }
 
+inline const char* MemberInfo::GetName() const {
+
+	return m_Name;
+}
+
+inline bool MemberInfo::HasOffset() const {
+
+	return m_ResolveMemberPointer == nullptr;
+}
+
+inline void* MemberInfo::GetAddress(void* object) const {
+
+	MIST_ASSERT(HasOffset());
+	MIST_ASSERT(object != nullptr);
+	return static_cast<unsigned char*>(object) + m_Offset;
+}
+
+inline const void* MemberInfo::GetAddress(const void* object) const {
+
+	MIST_ASSERT(HasOffset());
+	MIST_ASSERT(object != nullptr);
+	return static_cast<const unsigned char*>(object) + m_Offset;
+}
+
+inline void* MemberInfo::Resolve(void* object) {
+
+	if (HasOffset()) {
+		return GetAddress(object);
+	}
+
+	MIST_ASSERT(object != nullptr);
+	return m_ResolveMemberPointer(&m_MemberPointer, object);
+}
+
+inline const void* MemberInfo::Resolve(const void* object) {
+
+	return Resolve(const_cast<void*>(object));
+}
+
+inline size_t MemberInfo::GetOffset() const {
+
+	MIST_ASSERT(HasOffset());
+	return m_Offset;
+}
+
+inline size_t MemberInfo::GetSize() const {
+
+	return m_Size;
+}
+
+inline size_t MemberInfo::GetAlignment() const {
+
+	return m_Alignment;
+}
+
+inline bool MemberInfo::IsTriviallyCopyable() const {
+
+	return m_IsTriviallyCopyable;
+}
+
+inline bool MemberInfo::IsPaddingFree() const {
+
+	return m_IsPaddingFree;
+}
+
+inline TypeId MemberInfo::GetTypeId() const {
+
+	return m_TypeId;
+}
+
+inline TypeId MemberInfo::GetClassTypeId() const {
+
+	return m_ClassTypeId;
+}
+
+inline void MemberInfo::AddMemoryStats(MemoryStats* stats) const {
+
+	stats->m_MemberInfoBytes += sizeof(MemberInfo);
+	++stats->m_MemberCount;
+	m_MetaData.AddMemoryStats(stats);
+}
+
+template< typename MemberType, typename ClassType >
+void MemberInfo::Gather(ClassType* const* objects, size_t count, MemberType* output) {
+
+	MIST_ASSERT(objects != nullptr || count == 0);
+	MIST_ASSERT(output != nullptr || count == 0);
+
+	if (HasOffset() == false) {
+		for (size_t i = 0; i < count; ++i) {
+			output[i] = *Get<MemberType>(objects[i]);
+		}
+		return;
+	}
+
+	// The requested types must match the registered member exactly
+	MIST_ASSERT(m_TypeId == TypeId::Get<MemberType>());
+	MIST_ASSERT(m_ClassTypeId == TypeId::Get<ClassType>());
+
+	const size_t offset = m_Offset;
+	for (size_t i = 0; i < count; ++i) {
+		MIST_ASSERT(objects[i] != nullptr);
+		output[i] = *reinterpret_cast<const MemberType*>(reinterpret_cast<const unsigned char*>(objects[i]) + offset);
+	}
+}
+
+template< typename MemberType >
+void MemberInfo::GatherStrided(const void* first, size_t stride, size_t count, MemberType* output) const {
+
+	MIST_ASSERT(HasOffset());
+	MIST_ASSERT(m_TypeId == TypeId::Get<MemberType>());
+	MIST_ASSERT(first != nullptr || count == 0);
+
+	const unsigned char* source = static_cast<const unsigned char*>(first) + m_Offset;
+	Detail::CopyStrided(source, stride, count, output, std::is_trivially_copyable<MemberType>());
+}
+
+template< typename MemberType, typename ClassType >
+void MemberInfo::Scatter(ClassType* const* objects, size_t count, const MemberType* input) {
+
+	MIST_ASSERT(objects != nullptr || count == 0);
+	MIST_ASSERT(input != nullptr || count == 0);
+
+	if (HasOffset() == false) {
+		for (size_t i = 0; i < count; ++i) {
+			*Get<MemberType>(objects[i]) = input[i];
+		}
+		return;
+	}
+
+	// The requested types must match the registered member exactly
+	MIST_ASSERT(m_TypeId == TypeId::Get<MemberType>());
+	MIST_ASSERT(m_ClassTypeId == TypeId::Get<ClassType>());
+
+	const size_t offset = m_Offset;
+	for (size_t i = 0; i < count; ++i) {
+		MIST_ASSERT(objects[i] != nullptr);
+		*reinterpret_cast<MemberType*>(reinterpret_cast<unsigned char*>(objects[i]) + offset) = input[i];
+	}
+}
+
+template< typename MemberType >
+void MemberInfo::ScatterStrided(void* first, size_t stride, size_t count, const MemberType* input) const {
+
+	MIST_ASSERT(HasOffset());
+	MIST_ASSERT(m_TypeId == TypeId::Get<MemberType>());
+	MIST_ASSERT(first != nullptr || count == 0);
+
+	unsigned char* destination = static_cast<unsigned char*>(first) + m_Offset;
+	Detail::WriteStrided(destination, stride, count, input, std::is_trivially_copyable<MemberType>());
+}
+
 template< typename ClassType, typename MemberType >
 MemberInfo::MemberInfo(MemberInfo::MemberPointer<ClassType, MemberType> memberPointer) 
-	: m_MemberRetrieval([=](ClassType* object)->MemberType*{
-	
-		return &(object->*memberPointer);
-	}) {
+	: m_ResolveMemberPointer(std::is_standard_layout<ClassType>::value ? nullptr : &ResolveMemberPointer<ClassType, MemberType>)
+	, m_TypeId(TypeId::Get<MemberType>())
+	, m_ClassTypeId(TypeId::Get<ClassType>())
+	, m_Name(nullptr)
+	, m_Size(static_cast<uint32_t>(sizeof(MemberType)))
+	, m_Alignment(static_cast<uint32_t>(alignof(MemberType)))
+	, m_IsTriviallyCopyable(std::is_trivially_copyable<MemberType>::value)
+	, m_IsPaddingFree(Detail::IsPaddingFree<MemberType>::value) {
+
+	static_assert(sizeof(memberPointer) <= sizeof(m_MemberPointer), "The member pointer doesn't fit the member info");
+
+	if (HasOffset()) {
+		m_Offset = Detail::MemberOffset(memberPointer);
+	}
+	else {
+		new (&m_MemberPointer) MemberPointer<ClassType, MemberType>(memberPointer);
+	}
 }
 
-MemberInfo::MemberInfo(MemberInfo&& move) : m_MetaData(std::move(move.m_MetaData)), m_MemberRetrieval(std::move(move.m_MemberRetrieval)) {}
+MemberInfo::MemberInfo(MemberInfo&& move) 
+	: m_MetaData(std::move(move.m_MetaData))
+	, m_MemberPointer(move.m_MemberPointer)
+	, m_ResolveMemberPointer(move.m_ResolveMemberPointer)
+	, m_TypeId(move.m_TypeId)
+	, m_ClassTypeId(move.m_ClassTypeId)
+	, m_Name(move.m_Name)
+	, m_Size(move.m_Size)
+	, m_Alignment(move.m_Alignment)
+	, m_IsTriviallyCopyable(move.m_IsTriviallyCopyable)
+	, m_IsPaddingFree(move.m_IsPaddingFree) {
+}
 
 MemberInfo& MemberInfo::operator=(MemberInfo&& move) {
 
 	m_MetaData = std::move(move.m_MetaData);
-	m_MemberRetrieval = std::move(move.m_MemberRetrieval);
+	m_MemberPointer = move.m_MemberPointer;
+	m_ResolveMemberPointer = move.m_ResolveMemberPointer;
+	m_TypeId = move.m_TypeId;
+	m_ClassTypeId = move.m_ClassTypeId;
+	m_Name = move.m_Name;
+	m_Size = move.m_Size;
+	m_Alignment = move.m_Alignment;
+	m_IsTriviallyCopyable = move.m_IsTriviallyCopyable;
+	m_IsPaddingFree = move.m_IsPaddingFree;
 	return *this;
 }
 
+template< typename ClassType, typename MemberType >
+void* MemberInfo::ResolveMemberPointer(const void* memberPointer, void* object) {
+
+	MemberPointer<ClassType, MemberType> member = *static_cast<const MemberPointer<ClassType, MemberType>*>(memberPointer);
+	return &(static_cast<ClassType*>(object)->*member);
+}
+
+namespace Detail {
+
+	template< typename ClassType, typename MemberType >
+	size_t MemberOffset(MemberType ClassType::* memberPointer) {
+
+		typename std::aligned_storage<sizeof(ClassType), alignof(ClassType)>::type storage;
+		const ClassType* object = reinterpret_cast<const ClassType*>(&storage);
+
+		const unsigned char* member = reinterpret_cast<const unsigned char*>(&(object->*memberPointer));
+		return static_cast<size_t>(member - reinterpret_cast<const unsigned char*>(&storage));
+	}
+
+	template< typename MemberType >
+	void CopyStrided(const unsigned char* source, size_t stride, size_t count, MemberType* output, std::true_type) {
+
+		// Densely packed values are a single copy
+		if (stride == sizeof(MemberType)) {
+			std::memcpy(output, source, count * sizeof(MemberType));
+			return;
+		}
+
+		unsigned char* destination = reinterpret_cast<unsigned char*>(output);
+		for (size_t i = 0; i < count; ++i) {
+			std::memcpy(destination + i * sizeof(MemberType), source + i * stride, sizeof(MemberType));
+		}
+	}
+
+	template< typename MemberType >
+	void CopyStrided(const unsigned char* source, size_t stride, size_t count, MemberType* output, std::false_type) {
+
+		for (size_t i = 0; i < count; ++i) {
+			output[i] = *reinterpret_cast<const MemberType*>(source + i * stride);
+		}
+	}
+
+	template< typename MemberType >
+	void WriteStrided(unsigned char* destination, size_t stride, size_t count, const MemberType* input, std::true_type) {
+
+		// Densely packed values are a single copy
+		if (stride == sizeof(MemberType)) {
+			std::memcpy(destination, input, count * sizeof(MemberType));
+			return;
+		}
+
+		const unsigned char* source = reinterpret_cast<const unsigned char*>(input);
+		for (size_t i = 0; i < count; ++i) {
+			std::memcpy(destination + i * stride, source + i * sizeof(MemberType), sizeof(MemberType));
+		}
+	}
+
+	template< typename MemberType >
+	void WriteStrided(unsigned char* destination, size_t stride, size_t count, const MemberType* input, std::false_type) {
+
+		for (size_t i = 0; i < count; ++i) {
+			*reinterpret_cast<MemberType*>(destination + i * stride) = input[i];
+		}
+	}
+}
+
 MIST_NAMESPACE_END
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include "../Mist_hashing/include/HashID.h"
+#include <cstddef>
+
+MIST_NAMESPACE
+
+class TypeInfo;
+
+// Bytes of reflection data held by a registry, see Reflection::GetMemoryStats
+// @Detail: Heap bytes are the sizes requested from the allocator, allocator headers and the heap memory owned by values
+// themselves, such as the characters of a std::string meta data value, aren't counted.
+// Hash table bytes are estimated from the bucket and node counts of the usual standard library layout
+struct MemoryStats {
+
+	// Type infos, method infos, member infos, global functions and global objects
+	// including their inline delegates
+	size_t m_TypeInfoBytes = 0;
+	size_t m_MethodInfoBytes = 0;
+	size_t m_MemberInfoBytes = 0;
+	size_t m_GlobalBytes = 0;
+
+	// Constructors and deferred registrations, and every callable too large for the inline buffer of its delegate
+	size_t m_DelegateBytes = 0;
+
+	// Heap blocks of meta data entries that spilled past the inline ones
+	size_t m_MetaDataBytes = 0;
+
+	// Values too large for the inline buffer of their Any
+	size_t m_AnyBytes = 0;
+
+	// Buckets, nodes and keys of the hash maps, frozen and published lookup tables and the meta data index
+	size_t m_HashTableBytes = 0;
+
+	// Slabs of the object pools
+	size_t m_PoolBytes = 0;
+
+	size_t m_TypeCount = 0;
+	size_t m_MethodCount = 0;
+	size_t m_MemberCount = 0;
+	size_t m_GlobalCount = 0;
+	size_t m_MetaDataCount = 0;
+
+	inline size_t GetTotalBytes() const;
+
+	inline MemoryStats& operator+=(const MemoryStats& other);
+};
+
+// Memory held by a single type, its methods and its members, see Reflection::GetTypeMemoryStats
+struct TypeMemoryStats {
+	HashID::ValueType m_Name;
+	TypeInfo* m_Type;
+	MemoryStats m_Stats;
+};
+
+namespace Detail {
+
+	// Estimate the bytes of the buckets, node links and keys of an unordered map, the mapped values are left to the caller
+	template< typename MapType >
+	size_t GetHashTableSize(const MapType& map);
+}
+
+
+// -Implementation-
+
+inline size_t MemoryStats::GetTotalBytes() const {
+
+	return m_TypeInfoBytes + m_MethodInfoBytes + m_MemberInfoBytes + m_GlobalBytes + m_DelegateBytes
+		+ m_MetaDataBytes + m_AnyBytes + m_HashTableBytes + m_PoolBytes;
+}
+
+inline MemoryStats& MemoryStats::operator+=(const MemoryStats& other) {
+
+	m_TypeInfoBytes += other.m_TypeInfoBytes;
+	m_MethodInfoBytes += other.m_MethodInfoBytes;
+	m_MemberInfoBytes += other.m_MemberInfoBytes;
+	m_GlobalBytes += other.m_GlobalBytes;
+	m_DelegateBytes += other.m_DelegateBytes;
+	m_MetaDataBytes += other.m_MetaDataBytes;
+	m_AnyBytes += other.m_AnyBytes;
+	m_HashTableBytes += other.m_HashTableBytes;
+	m_PoolBytes += other.m_PoolBytes;
+
+	m_TypeCount += other.m_TypeCount;
+	m_MethodCount += other.m_MethodCount;
+	m_MemberCount += other.m_MemberCount;
+	m_GlobalCount += other.m_GlobalCount;
+	m_MetaDataCount += other.m_MetaDataCount;
+	return *this;
+}
+
+namespace Detail {
+
+	template< typename MapType >
+	size_t GetHashTableSize(const MapType& map) {
+
+		// Every bucket holds a link, every node holds a link to the next node and the key next to the mapped value
+		const size_t nodeOverhead = sizeof(void*) + sizeof(typename MapType::value_type) - sizeof(typename MapType::mapped_type);
+		return map.bucket_count() * sizeof(void*) + map.size() * nodeOverhead;
+	}
+}
+
+MIST_NAMESPACE_END
@@ -3,20 +3,40 @@
 #include <Mist_Common/include/UtilityMacros.h>
 #include "../Mist_hashing/include/HashID.h"
 #include "Any.h"
-#include <unordered_map>
-
+#include "MemoryStats.h"
+#include "MetaDataIndex.h"
+#include "RegistrationProfiler.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Number of entries held inside the meta data before they spill to the heap
+#ifndef MIST_METADATA_INLINE_CAPACITY
+#define MIST_METADATA_INLINE_CAPACITY 1
+#endif
 
 MIST_NAMESPACE
 
 // The meta data class will hold all of the meta data associated to a particular
 // info in the reflection table.
 // @Detail: When requesting a type, the type must match the insterted type exactly or else an assert will be hit.
+// Entries are kept sorted by id, the first MIST_METADATA_INLINE_CAPACITY entries are held inline and larger
+// meta data spills to a heap block that doubles when full. The heap pointer shares the inline storage.
+// Pointers returned by Add and Get are valid until the next Add, moving the meta data keeps a heap block in place
+// but moves inline entries.
 class MetaData {
 
 public:
 
+	// -Types-
+	using Entry = std::pair<HashID::ValueType, Any>;
+	using Iterator = Entry*;
+
 	// -Public API-
-	
+
 	// Add data to the meta data at the location of id
 	template< typename Type >
 	Type* Add(HashID id, Type data);
@@ -24,20 +44,33 @@ public:
 	// Retrieve data from the meta data at the location of id
 	template< typename Type >
 	Type* Get(HashID id);
-	
+
 	// Determine if the meta data has data at the location of id
 	inline bool Has(HashID id) const;
 
-	// -Types-
-	using Iterator = std::unordered_map<uint32_t, Any>::iterator;
+	// Lock the entries, no data can be added afterwards
+	// @Detail: Entries are always sorted, lookups don't change once frozen
+	inline void Freeze();
+
+	inline bool IsFrozen() const;
+
+	inline size_t Size() const;
+
+	// Add the heap block of entries and the values held on the heap by the entries to stats
+	inline void AddMemoryStats(MemoryStats* stats) const;
+
+	// Retrieve the index the keys are inserted into as they're added, null if the meta data isn't attached to one
+	inline Detail::MetaDataIndex* GetIndex() const;
 
 	// -Iterators-
 
 	// User lowercase in order to be able to use range based loop
+	// @Detail: Entries are iterated in id order
 	inline Iterator begin();
 	inline Iterator end();
 
-	MetaData() = default;
+	inline MetaData();
+	inline ~MetaData();
 
 	MetaData(const MetaData&) = delete;
 	MetaData& operator=(const MetaData&) = delete;
@@ -47,8 +80,39 @@ public:
 
 private:
 
-	std::unordered_map<uint32_t, Any> m_Data;
+	friend class Detail::MetaDataIndex;
 
+	// Retrieve the first entry whose id isn't less than id
+	inline Entry* LowerBound(HashID::ValueType id) const;
+
+	// Insert an entry before position, growing the entries once they're full
+	inline Entry* Insert(Entry* position, HashID::ValueType id, Any&& value);
+
+	// Move the entries to a heap block of capacity entries
+	inline void Reallocate(uint32_t capacity);
+
+	inline bool IsInline() const;
+	inline Entry* GetEntries() const;
+
+	// Take the entries of move, leaving it empty
+	inline void MoveEntries(MetaData&& move);
+
+	inline void DestroyEntries();
+
+	static_assert(MIST_METADATA_INLINE_CAPACITY > 0, "Meta data needs room for at least one inline entry");
+	static const uint32_t INLINE_CAPACITY = MIST_METADATA_INLINE_CAPACITY;
+
+	// Sorted by id, inline until the capacity grows past INLINE_CAPACITY
+	union {
+		typename std::aligned_storage<sizeof(Entry) * INLINE_CAPACITY, alignof(Entry)>::type m_Inline;
+		Entry* m_Heap;
+	};
+
+	// Index of the reflection owning the info, see Detail::MetaDataIndex::Attach
+	Detail::MetaDataIndex* m_Index;
+	uint32_t m_Size;
+	uint32_t m_Capacity : 31;
+	uint32_t m_IsFrozen : 1;
 };
 
 
@@ -60,13 +124,18 @@ Type* MetaData::Add(HashID id, Type data) {
 	// If this is hit, there is already an item at this location. There has either been a collision
 	// with the hashing method or you're repeating a name.
 	MIST_ASSERT(Has(id) == false);
-	auto insertionResult = m_Data.emplace(id.GetValue(), Any(data));
 
-	// The insertion must have worked, if it didn't check the id and try again
-	MIST_ASSERT(insertionResult.second == true);
-	MIST_ASSERT(m_Data[id.GetValue()].Is<Type>());
+	// Frozen meta data can't be modified
+	MIST_ASSERT(IsFrozen() == false);
+	Entry* entry = Insert(LowerBound(id.GetValue()), id.GetValue(), Any(data));
 
-	return Cast<Type>(m_Data[id.GetValue()]);
+	MIST_ASSERT(entry->second.Is<Type>());
+	MIST_PROFILE_REGISTRATION_COUNT(m_MetaDataCount);
+
+	if (m_Index != nullptr) {
+		m_Index->Insert(this, id.GetValue());
+	}
+	return Cast<Type>(entry->second);
 }
 
 // Retrieve data from the meta data at the location of id
@@ -77,35 +146,233 @@ Type* MetaData::Get(HashID id) {
 	// id is present.
 	MIST_ASSERT(Has(id));
 
-	Any& any = m_Data[id.GetValue()];
+	Any& any = LowerBound(id.GetValue())->second;
 
 	// The retrieved type must match the other
 	MIST_ASSERT(any.Is<Type>());
-	return Cast<Type>(m_Data[id.GetValue()]);
+	return Cast<Type>(any);
 }
 
 inline bool MetaData::Has(HashID id) const {
 
-	return m_Data.find(id.GetValue()) != m_Data.cend();
+	Entry* found = LowerBound(id.GetValue());
+	return found != GetEntries() + m_Size && found->first == id.GetValue();
+}
+
+inline void MetaData::Freeze() {
+
+	m_IsFrozen = 1;
+}
+
+inline bool MetaData::IsFrozen() const {
+
+	return m_IsFrozen != 0;
+}
+
+inline size_t MetaData::Size() const {
+
+	return m_Size;
+}
+
+inline void MetaData::AddMemoryStats(MemoryStats* stats) const {
+
+	const Entry* entries = GetEntries();
+	if (IsInline() == false) {
+		stats->m_MetaDataBytes += sizeof(Entry) * m_Capacity;
+	}
+	for (uint32_t i = 0; i < m_Size; ++i) {
+		stats->m_AnyBytes += entries[i].second.GetHeapSize();
+	}
+	stats->m_MetaDataCount += m_Size;
+}
+
+inline Detail::MetaDataIndex* MetaData::GetIndex() const {
+
+	return m_Index;
 }
 
 inline MetaData::Iterator MetaData::begin() {
-	
-	return m_Data.begin();
+
+	return GetEntries();
 }
 
 inline MetaData::Iterator MetaData::end() {
 
-	return m_Data.end();
+	return GetEntries() + m_Size;
+}
+
+inline MetaData::Entry* MetaData::LowerBound(HashID::ValueType id) const {
+
+	// Most meta data holds a few entries, a linear search beats a binary search on those
+	Entry* entry = GetEntries();
+	Entry* end = entry + m_Size;
+	if (m_Size <= 4) {
+		while (entry != end && entry->first < id) {
+			++entry;
+		}
+		return entry;
+	}
+
+	return std::lower_bound(entry, end, id, [](const Entry& left, HashID::ValueType right) { return left.first < right; });
 }
 
-MetaData::MetaData(MetaData&& move) : m_Data(std::move(move.m_Data)) {
+inline MetaData::Entry* MetaData::Insert(Entry* position, HashID::ValueType id, Any&& value) {
 
+	const size_t index = position - GetEntries();
+	if (m_Size == m_Capacity) {
+		Reallocate(m_Capacity * 2);
+	}
+
+	// Append the entry and rotate it into place
+	Entry* entries = GetEntries();
+	Entry* end = entries + m_Size;
+	new (end) Entry(id, std::move(value));
+	++m_Size;
+
+	std::rotate(entries + index, end, end + 1);
+	return entries + index;
+}
+
+inline void MetaData::Reallocate(uint32_t capacity) {
+
+	MIST_ASSERT(capacity >= m_Size && capacity > INLINE_CAPACITY && capacity < (1u << 31));
+
+	Entry* entries = static_cast<Entry*>(::operator new(sizeof(Entry) * capacity));
+	Entry* previous = GetEntries();
+	for (uint32_t i = 0; i < m_Size; ++i) {
+		new (entries + i) Entry(std::move(previous[i]));
+		previous[i].~Entry();
+	}
+
+	if (IsInline() == false) {
+		::operator delete(previous);
+	}
+	m_Heap = entries;
+	m_Capacity = capacity;
+}
+
+inline bool MetaData::IsInline() const {
+
+	return m_Capacity == INLINE_CAPACITY;
 }
-MetaData& MetaData::operator=(MetaData&& move) {
 
-	m_Data = std::move(move.m_Data);
+inline MetaData::Entry* MetaData::GetEntries() const {
+
+	return IsInline() ? reinterpret_cast<Entry*>(const_cast<void*>(static_cast<const void*>(&m_Inline))) : m_Heap;
+}
+
+inline void MetaData::MoveEntries(MetaData&& move) {
+
+	// The index references the info that owned the entries, the info taking them attaches them again
+	if (move.m_Index != nullptr) {
+		move.m_Index->Detach(&move);
+	}
+
+	m_IsFrozen = move.m_IsFrozen;
+
+	// A heap block changes owner without moving the entries
+	if (move.IsInline() == false) {
+		m_Heap = move.m_Heap;
+		m_Size = move.m_Size;
+		m_Capacity = move.m_Capacity;
+		move.m_Size = 0;
+		move.m_Capacity = INLINE_CAPACITY;
+		return;
+	}
+
+	Entry* entries = GetEntries();
+	Entry* moved = move.GetEntries();
+	for (uint32_t i = 0; i < move.m_Size; ++i) {
+		new (entries + i) Entry(std::move(moved[i]));
+		moved[i].~Entry();
+	}
+	m_Size = move.m_Size;
+	move.m_Size = 0;
+}
+
+inline void MetaData::DestroyEntries() {
+
+	Entry* entries = GetEntries();
+	for (uint32_t i = 0; i < m_Size; ++i) {
+		entries[i].~Entry();
+	}
+
+	if (IsInline() == false) {
+		::operator delete(entries);
+	}
+	m_Size = 0;
+	m_Capacity = INLINE_CAPACITY;
+}
+
+inline MetaData::MetaData()
+	: m_Index(nullptr), m_Size(0), m_Capacity(INLINE_CAPACITY), m_IsFrozen(0) {}
+
+inline MetaData::~MetaData() {
+
+	if (m_Index != nullptr) {
+		m_Index->Detach(this);
+	}
+	DestroyEntries();
+}
+
+inline MetaData::MetaData(MetaData&& move)
+	: m_Index(nullptr), m_Size(0), m_Capacity(INLINE_CAPACITY), m_IsFrozen(0) {
+
+	MoveEntries(std::move(move));
+}
+
+inline MetaData& MetaData::operator=(MetaData&& move) {
+
+	if (this != &move) {
+
+		// The entries change but the info owning us doesn't, attach the new entries in place of ours
+		Detail::MetaDataIndex* index = m_Index;
+		TaggedInfo owner = {};
+		if (index != nullptr) {
+			owner = index->GetOwner(this);
+			index->Detach(this);
+		}
+
+		DestroyEntries();
+		MoveEntries(std::move(move));
+
+		if (index != nullptr) {
+			index->Attach(this, owner);
+		}
+	}
 	return *this;
 }
 
+namespace Detail {
+
+	inline void MetaDataIndex::Attach(MetaData* metaData, const TaggedInfo& info) {
+
+		if (metaData->m_Index != nullptr) {
+			metaData->m_Index->Detach(metaData);
+		}
+
+		metaData->m_Index = this;
+		m_Owners[metaData] = info;
+		for (const MetaData::Entry& entry : *metaData) {
+			m_Infos[entry.first].push_back(info);
+		}
+		++m_Generation;
+	}
+
+	inline void MetaDataIndex::Detach(MetaData* metaData) {
+
+		MIST_ASSERT(metaData->m_Index == this);
+
+		auto owner = m_Owners.find(metaData);
+		MIST_ASSERT(owner != m_Owners.end());
+
+		for (const MetaData::Entry& entry : *metaData) {
+			Erase(entry.first, owner->second.m_Info);
+		}
+		m_Owners.erase(owner);
+		metaData->m_Index = nullptr;
+		++m_Generation;
+	}
+}
+
 MIST_NAMESPACE_END
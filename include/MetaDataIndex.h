@@ -0,0 +1,200 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include "../Mist_hashing/include/HashID.h"
+#include "MemoryStats.h"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+MIST_NAMESPACE
+
+class MetaData;
+class TypeInfo;
+class MethodInfo;
+class MemberInfo;
+class GlobalFunction;
+class GlobalObject;
+
+// Info whose meta data carries a key, see Reflection::FindTagged
+struct TaggedInfo {
+
+	enum class Kind {
+		Type,
+		Method,
+		Member,
+		GlobalFunction,
+		GlobalObject
+	};
+
+	Kind m_Kind;
+
+	// Name the info was registered with
+	HashID::ValueType m_Name;
+
+	// Info of kind m_Kind, use the accessor of the kind
+	void* m_Info;
+
+	// Type holding the method or member, null for the other kinds
+	TypeInfo* m_Holder;
+
+	inline TypeInfo* GetTypeInfo() const;
+	inline MethodInfo* GetMethodInfo() const;
+	inline MemberInfo* GetMemberInfo() const;
+	inline GlobalFunction* GetGlobalFunction() const;
+	inline GlobalObject* GetGlobalObject() const;
+};
+
+namespace Detail {
+
+	// Inverted index of the meta data keys of a reflection, maps every key to the infos carrying it.
+	// Attached meta data inserts its keys as they're added and is removed from the index when it's moved or destroyed,
+	// the info owning each attached meta data is kept here rather than in the meta data.
+	// @Detail: Attach and Detach are defined with MetaData since they walk its entries
+	class MetaDataIndex {
+
+	public:
+
+		// -Public API-
+
+		// Index the keys of metaData as keys of info, and every key added to it from then on
+		// @Detail: Meta data attached to another index is detached from it first
+		inline void Attach(MetaData* metaData, const TaggedInfo& info);
+
+		// Remove the keys of metaData from the index
+		inline void Detach(MetaData* metaData);
+
+		// Index key, just added to the attached metaData
+		inline void Insert(const MetaData* metaData, HashID::ValueType key);
+
+		// Retrieve the info owning the attached metaData
+		inline const TaggedInfo& GetOwner(const MetaData* metaData) const;
+
+		// Retrieve the infos carrying key, empty if none does
+		inline const std::vector<TaggedInfo>& Find(HashID::ValueType key) const;
+
+		// Retrieve a counter bumped whenever attached meta data changes
+		inline size_t GetGeneration() const;
+
+		// Bump the generation for changes to the owning infos that don't go through their meta data
+		inline void BumpGeneration();
+
+		// Retrieve the size of the tables and of the info lists allocated on the heap
+		inline size_t GetHeapSize() const;
+
+		// -Structors-
+
+		inline MetaDataIndex();
+
+		MetaDataIndex(const MetaDataIndex&) = delete;
+		MetaDataIndex& operator=(const MetaDataIndex&) = delete;
+
+	private:
+
+		// Remove the info from the list of key
+		inline void Erase(HashID::ValueType key, const void* info);
+
+		std::unordered_map<HashID::ValueType, std::vector<TaggedInfo>> m_Infos;
+
+		// Info owning every attached meta data
+		std::unordered_map<const MetaData*, TaggedInfo> m_Owners;
+
+		size_t m_Generation;
+	};
+}
+
+
+// -Implementation-
+
+inline TypeInfo* TaggedInfo::GetTypeInfo() const {
+
+	MIST_ASSERT(m_Kind == Kind::Type);
+	return static_cast<TypeInfo*>(m_Info);
+}
+
+inline MethodInfo* TaggedInfo::GetMethodInfo() const {
+
+	MIST_ASSERT(m_Kind == Kind::Method);
+	return static_cast<MethodInfo*>(m_Info);
+}
+
+inline MemberInfo* TaggedInfo::GetMemberInfo() const {
+
+	MIST_ASSERT(m_Kind == Kind::Member);
+	return static_cast<MemberInfo*>(m_Info);
+}
+
+inline GlobalFunction* TaggedInfo::GetGlobalFunction() const {
+
+	MIST_ASSERT(m_Kind == Kind::GlobalFunction);
+	return static_cast<GlobalFunction*>(m_Info);
+}
+
+inline GlobalObject* TaggedInfo::GetGlobalObject() const {
+
+	MIST_ASSERT(m_Kind == Kind::GlobalObject);
+	return static_cast<GlobalObject*>(m_Info);
+}
+
+namespace Detail {
+
+	inline void MetaDataIndex::Insert(const MetaData* metaData, HashID::ValueType key) {
+
+		auto owner = m_Owners.find(metaData);
+		MIST_ASSERT(owner != m_Owners.end());
+
+		m_Infos[key].push_back(owner->second);
+		++m_Generation;
+	}
+
+	inline const std::vector<TaggedInfo>& MetaDataIndex::Find(HashID::ValueType key) const {
+
+		static const std::vector<TaggedInfo> EMPTY;
+
+		auto found = m_Infos.find(key);
+		return found != m_Infos.end() ? found->second : EMPTY;
+	}
+
+	inline const TaggedInfo& MetaDataIndex::GetOwner(const MetaData* metaData) const {
+
+		auto owner = m_Owners.find(metaData);
+		MIST_ASSERT(owner != m_Owners.end());
+		return owner->second;
+	}
+
+	inline size_t MetaDataIndex::GetGeneration() const {
+
+		return m_Generation;
+	}
+
+	inline void MetaDataIndex::BumpGeneration() {
+
+		++m_Generation;
+	}
+
+	inline size_t MetaDataIndex::GetHeapSize() const {
+
+		size_t size = GetHashTableSize(m_Infos) + m_Infos.size() * sizeof(std::vector<TaggedInfo>)
+			+ GetHashTableSize(m_Owners) + m_Owners.size() * sizeof(TaggedInfo);
+		for (const auto& infos : m_Infos) {
+			size += infos.second.capacity() * sizeof(TaggedInfo);
+		}
+		return size;
+	}
+
+	inline MetaDataIndex::MetaDataIndex() : m_Generation(0) {}
+
+	inline void MetaDataIndex::Erase(HashID::ValueType key, const void* info) {
+
+		auto infos = m_Infos.find(key);
+		MIST_ASSERT(infos != m_Infos.end());
+
+		std::vector<TaggedInfo>& list = infos->second;
+		list.erase(std::remove_if(list.begin(), list.end(), [info](const TaggedInfo& tagged) { return tagged.m_Info == info; }), list.end());
+		if (list.empty()) {
+			m_Infos.erase(infos);
+		}
+	}
+}
+
+MIST_NAMESPACE_END
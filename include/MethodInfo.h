@@ -3,6 +3,8 @@
 #include <Mist_Common/include/UtilityMacros.h>
 #include "MetaData.h"
 #include "Delegate.h"
+#include "Parallel.h"
+#include <cstddef>
 
 MIST_NAMESPACE
 
@@ -11,20 +13,50 @@ class MethodInfo {
 
 public:
 
+	// -Types-
+
+	template< typename ClassType, typename ReturnType, typename... Arguments >
+	using MethodPointer = ReturnType(ClassType::*) (Arguments...);
+
+	// Handle to a method invoked as handle(object, arguments...)
+	template< typename ReturnType, typename ClassType, typename... Arguments >
+	using Bound = BoundDelegate<ReturnType, ClassType*, Arguments...>;
+
 	// -Public API-
 
 	// Invoke the method on the object of type ClassType
 	// The method signature must match the passed in method's exactly
+	// @Detail: Arguments are forwarded to the method, the signature is deduced from the decayed
+	// argument types unless Arguments are given explicitly
+	template< typename ReturnType, typename ClassType, typename... Arguments, typename... Forwarded >
+	ReturnType Invoke(ClassType* object, Forwarded&&... arguments);
+
+	// Validate the method signature once and retrieve a handle that invokes the method directly
+	// @Detail: The handle is only valid for as long as the MethodInfo isn't moved or destroyed,
+	// an invalid handle is returned if the signature doesn't match
 	template< typename ReturnType, typename ClassType, typename... Arguments >
-	ReturnType Invoke(ClassType* object, Arguments... arguments);
+	Bound<ReturnType, ClassType, Arguments...> Bind();
+
+	// Invoke the method on every object, the i-th call receives the i-th element of every argument array
+	// @Detail: The signature is validated once for the whole batch,
+	// the i-th return value is written to results[i] if results isn't null.
+	// The arrays hold the decayed parameter types, a const std::string& parameter reads from a std::string array
+	template< typename ReturnType, typename ClassType, typename... Arguments >
+	void InvokeBatch(ClassType* const* objects, size_t count, ReturnType* results, const typename std::decay<Arguments>::type*... arguments);
+
+	// Invoke the method on every object, splitting the objects in threadCount chunks run by the worker pool
+	// @Detail: A thread count of 0 uses the hardware concurrency, the method must be safe to call concurrently on distinct objects
+	template< typename ReturnType, typename ClassType, typename... Arguments >
+	void InvokeBatchParallel(size_t threadCount, ClassType* const* objects, size_t count, ReturnType* results, const typename std::decay<Arguments>::type*... arguments);
 
 
 	inline MetaData* GetMetaData();
 
-	// -Types-
+	// Retrieve the identity of the ReturnType(ClassType*, Arguments...) signature of the method
+	inline TypeId GetSignature() const;
 
-	template< typename ClassType, typename ReturnType, typename... Arguments >
-	using MethodPointer = ReturnType(ClassType::*) (Arguments...);
+	// Add the size of the method info, its callable and its meta data to stats
+	inline void AddMemoryStats(MemoryStats* stats) const;
 
 	// -Structors-
 
@@ -46,28 +78,74 @@ private:
 
 // -Implementation-
 
-template< typename ReturnType, typename ClassType, typename... Arguments >
-ReturnType MethodInfo::Invoke(ClassType* object, Arguments... arguments) {
+template< typename ReturnType, typename ClassType, typename... Arguments, typename... Forwarded >
+ReturnType MethodInfo::Invoke(ClassType* object, Forwarded&&... arguments) {
 
 	MIST_ASSERT(object != nullptr);
 
-	return m_Method.Invoke<ReturnType, ClassType*, Arguments...>(object, arguments...);
+	using Signature = typename Detail::PrependType<ClassType*,
+		typename Detail::ArgumentList<Detail::TypeList<Arguments...>, Forwarded...>::List>::List;
+	return m_Method.InvokeSignature<ReturnType>(Signature(), object, std::forward<Forwarded>(arguments)...);
+}
+
+template< typename ReturnType, typename ClassType, typename... Arguments >
+MethodInfo::Bound<ReturnType, ClassType, Arguments...> MethodInfo::Bind() {
+
+	return m_Method.Bind<ReturnType, ClassType*, Arguments...>();
 }
 
+template< typename ReturnType, typename ClassType, typename... Arguments >
+void MethodInfo::InvokeBatch(ClassType* const* objects, size_t count, ReturnType* results, const typename std::decay<Arguments>::type*... arguments) {
+
+	MIST_ASSERT(objects != nullptr || count == 0);
+
+	// The method signature must match the passed in method's exactly
+	Bound<ReturnType, ClassType, Arguments...> bound = Bind<ReturnType, ClassType, Arguments...>();
+	MIST_ASSERT(bound.IsValid());
+
+	Detail::InvokeBatch(bound, 0, count, results, objects, arguments...);
+}
+
+template< typename ReturnType, typename ClassType, typename... Arguments >
+void MethodInfo::InvokeBatchParallel(size_t threadCount, ClassType* const* objects, size_t count, ReturnType* results, const typename std::decay<Arguments>::type*... arguments) {
+
+	MIST_ASSERT(objects != nullptr || count == 0);
+
+	// The method signature must match the passed in method's exactly
+	Bound<ReturnType, ClassType, Arguments...> bound = Bind<ReturnType, ClassType, Arguments...>();
+	MIST_ASSERT(bound.IsValid());
+
+	Detail::ParallelFor(count, threadCount, [&](size_t begin, size_t end) {
+		Detail::InvokeBatch(bound, begin, end, results, objects, arguments...);
+	});
+}
 
 inline MetaData* MethodInfo::GetMetaData() {
 
 	return &m_MetaData;
 }
 
+inline void MethodInfo::AddMemoryStats(MemoryStats* stats) const {
+
+	stats->m_MethodInfoBytes += sizeof(MethodInfo);
+	stats->m_DelegateBytes += m_Method.GetHeapSize();
+	++stats->m_MethodCount;
+	m_MetaData.AddMemoryStats(stats);
+}
+
 template< typename ClassType, typename ReturnType, typename... Arguments >
 MethodInfo::MethodInfo(MethodInfo::MethodPointer<ClassType, ReturnType, Arguments...> method) 
 	: m_Method([=](ClassType* object, Arguments... arguments)->ReturnType {
 
-		return (object->*method)(arguments...);
+		return (object->*method)(std::forward<Arguments>(arguments)...);
 	}) {
 }
 
+inline TypeId MethodInfo::GetSignature() const {
+
+	return m_Method.GetSignature();
+}
+
 inline MethodInfo::MethodInfo(MethodInfo&& move) : m_MetaData(std::move(move.m_MetaData)), m_Method(std::move(move.m_Method)) {}
 
 inline MethodInfo& MethodInfo::operator=(MethodInfo&& move) {
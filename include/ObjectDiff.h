@@ -0,0 +1,102 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include "BinarySerializer.h"
+#include "Delegate.h"
+#include "LayoutBuilder.h"
+#include "TypeId.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+MIST_NAMESPACE
+
+// ObjectDiff compares two instances of a reflected type member by member and produces a patch of the changed fields,
+// the patch is applied to another instance to replicate the changes.
+// Every reflected member is a field, members of reflected types are diffed field by field. The layout of a type is built once:
+// adjacent members that can be copied bytewise are compared as a single block and only blocks that differ are compared field by field.
+// A patch is a list of field indices, each followed by the new value of the field, ending with a zero.
+// @Detail: Members that are neither reflected nor free of padding need a codec, std::string has one by default.
+// A type that can't be laid out asserts and is neither diffed nor patched.
+// Patches are only valid between processes with the same registrations and layouts, values are in the native byte order.
+// Layouts reference the type infos of the reflection, every nested type must be registered (and materialized if deferred)
+// before its first use. ObjectDiff isn't thread safe, use one per thread.
+class ObjectDiff {
+
+public:
+
+	// -Public API-
+
+	// Append the patch turning before into after to output, returns false if the objects are equal
+	// @Detail: A patch is written even if the objects are equal, applying it does nothing.
+	// Nothing is written for a type that can't be laid out
+	template< typename Type >
+	bool Diff(const Type& before, const Type& after, std::vector<unsigned char>* output);
+
+	bool Diff(TypeId type, const void* before, const void* after, std::vector<unsigned char>* output);
+
+	// Apply the patch at cursor to object, the cursor is advanced past the patch
+	// @Detail: Returns false if the patch is truncated or references unknown fields, the object is then partially patched
+	template< typename Type >
+	bool Apply(const unsigned char** cursor, const unsigned char* end, Type* object);
+
+	bool Apply(TypeId type, const unsigned char** cursor, const unsigned char* end, void* object);
+
+	// Register the functions comparing and serializing a type that isn't reflected or free of padding
+	// @Detail: Codecs must be added before the first layout that uses the type is built
+	template< typename Type >
+	void AddCodec(bool(*equals)(const Type& left, const Type& right),
+		void(*write)(const Type& object, std::vector<unsigned char>* output), bool(*read)(const unsigned char** cursor, const unsigned char* end, Type* object));
+
+	// -Structors-
+
+	explicit ObjectDiff(Reflection* reflection);
+
+	ObjectDiff(const ObjectDiff&) = delete;
+	ObjectDiff& operator=(const ObjectDiff&) = delete;
+
+private:
+
+	bool DiffObject(const Detail::Layout& layout, const unsigned char* before, const unsigned char* after, std::vector<unsigned char>* output);
+	bool DiffValue(const Detail::LayoutField& field, uint32_t index, const unsigned char* before, const unsigned char* after, std::vector<unsigned char>* output);
+	bool ApplyObject(const Detail::Layout& layout, const unsigned char** cursor, const unsigned char* end, unsigned char* object);
+
+	Detail::LayoutBuilder m_Layouts;
+	BinarySerializer m_Serializer;
+
+	// bool(const void* left, const void* right)
+	std::unordered_map<TypeId, std::unique_ptr<Delegate>> m_Comparers;
+};
+
+
+// -Implementation-
+
+template< typename Type >
+bool ObjectDiff::Diff(const Type& before, const Type& after, std::vector<unsigned char>* output) {
+
+	return Diff(TypeId::Get<Type>(), &before, &after, output);
+}
+
+template< typename Type >
+bool ObjectDiff::Apply(const unsigned char** cursor, const unsigned char* end, Type* object) {
+
+	return Apply(TypeId::Get<Type>(), cursor, end, object);
+}
+
+template< typename Type >
+void ObjectDiff::AddCodec(bool(*equals)(const Type&, const Type&),
+	void(*write)(const Type&, std::vector<unsigned char>*), bool(*read)(const unsigned char**, const unsigned char*, Type*)) {
+
+	MIST_ASSERT(equals != nullptr);
+
+	m_Serializer.AddCodec<Type>(write, read);
+	std::unique_ptr<Delegate>& comparer = m_Comparers[TypeId::Get<Type>()];
+	comparer.reset(new Delegate([equals](const void* left, const void* right) {
+		return equals(*static_cast<const Type*>(left), *static_cast<const Type*>(right));
+	}));
+	m_Layouts.AddCustom(TypeId::Get<Type>(), comparer.get());
+}
+
+MIST_NAMESPACE_END
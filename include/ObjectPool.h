@@ -0,0 +1,197 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+MIST_NAMESPACE
+
+// Occupancy of an object pool
+struct PoolStats {
+
+	// Size in bytes of a single slot
+	size_t m_SlotSize;
+
+	// Number of slots owned by the pool, free or not
+	size_t m_Capacity;
+
+	// Number of slots currently handed out
+	size_t m_LiveCount;
+
+	// Highest number of slots handed out at once
+	size_t m_PeakLiveCount;
+
+	// Number of slabs allocated by the pool
+	size_t m_SlabCount;
+};
+
+// ObjectPool recycles fixed size slots of memory allocated in slabs.
+// Freed slots are kept in a free list and handed out again before a new slab is allocated.
+// @Detail: The pool is thread safe. Slabs are only released when the pool is destroyed,
+// every slot must be freed before then since the memory of live slots is released with the slabs.
+class ObjectPool {
+
+public:
+
+	// -Public API-
+
+	// Retrieve an uninitialized slot
+	inline void* Allocate();
+
+	// Return a slot retrieved through Allocate to the pool
+	inline void Free(void* slot);
+
+	// Determine if the slot was retrieved from this pool
+	inline bool Owns(const void* slot) const;
+
+	inline PoolStats GetStats() const;
+
+	// -Structors-
+
+	inline ObjectPool(size_t slotSize, size_t slotAlignment, size_t slotsPerSlab);
+	inline ~ObjectPool();
+
+	ObjectPool(const ObjectPool&) = delete;
+	ObjectPool& operator=(const ObjectPool&) = delete;
+
+private:
+
+	struct Slab {
+		void* m_Memory;
+		unsigned char* m_Begin;
+	};
+
+	// Allocate a new slab and thread its slots into the free list, the lock must be held
+	inline void AddSlab();
+
+	size_t m_SlotSize;
+	size_t m_SlotAlignment;
+	size_t m_SlotsPerSlab;
+
+	std::vector<Slab> m_Slabs;
+
+	// Every free slot holds the address of the next free slot
+	void* m_FreeList;
+
+	size_t m_LiveCount;
+	size_t m_PeakLiveCount;
+
+	mutable std::mutex m_Lock;
+};
+
+
+// -Implementation-
+
+inline void* ObjectPool::Allocate() {
+
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	if (m_FreeList == nullptr) {
+		AddSlab();
+	}
+
+	void* slot = m_FreeList;
+	m_FreeList = *static_cast<void**>(slot);
+
+	++m_LiveCount;
+	m_PeakLiveCount = std::max(m_PeakLiveCount, m_LiveCount);
+	return slot;
+}
+
+inline void ObjectPool::Free(void* slot) {
+
+	if (slot == nullptr) {
+		return;
+	}
+
+	// The slot doesn't belong to this pool
+	MIST_ASSERT(Owns(slot));
+
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	MIST_ASSERT(m_LiveCount > 0);
+
+	*static_cast<void**>(slot) = m_FreeList;
+	m_FreeList = slot;
+	--m_LiveCount;
+}
+
+inline bool ObjectPool::Owns(const void* slot) const {
+
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	const unsigned char* address = static_cast<const unsigned char*>(slot);
+	const size_t slabSize = m_SlotSize * m_SlotsPerSlab;
+	for (const Slab& slab : m_Slabs) {
+		if (address >= slab.m_Begin && address < slab.m_Begin + slabSize) {
+			return (address - slab.m_Begin) % m_SlotSize == 0;
+		}
+	}
+	return false;
+}
+
+inline PoolStats ObjectPool::GetStats() const {
+
+	std::lock_guard<std::mutex> lock(m_Lock);
+
+	PoolStats stats;
+	stats.m_SlotSize = m_SlotSize;
+	stats.m_Capacity = m_Slabs.size() * m_SlotsPerSlab;
+	stats.m_LiveCount = m_LiveCount;
+	stats.m_PeakLiveCount = m_PeakLiveCount;
+	stats.m_SlabCount = m_Slabs.size();
+	return stats;
+}
+
+inline void ObjectPool::AddSlab() {
+
+	// Over allocate to be able to align the first slot
+	const size_t slabSize = m_SlotSize * m_SlotsPerSlab;
+	void* memory = ::operator new(slabSize + m_SlotAlignment - 1);
+
+	const uintptr_t address = reinterpret_cast<uintptr_t>(memory);
+	const uintptr_t aligned = (address + m_SlotAlignment - 1) / m_SlotAlignment * m_SlotAlignment;
+
+	Slab slab;
+	slab.m_Memory = memory;
+	slab.m_Begin = static_cast<unsigned char*>(memory) + (aligned - address);
+	m_Slabs.push_back(slab);
+
+	// Thread the slots in reverse to hand them out in address order
+	for (size_t i = m_SlotsPerSlab; i > 0; --i) {
+		void* slot = slab.m_Begin + (i - 1) * m_SlotSize;
+		*static_cast<void**>(slot) = m_FreeList;
+		m_FreeList = slot;
+	}
+}
+
+inline ObjectPool::ObjectPool(size_t slotSize, size_t slotAlignment, size_t slotsPerSlab)
+	: m_SlotAlignment(std::max(slotAlignment, alignof(void*)))
+	, m_SlotsPerSlab(std::max<size_t>(slotsPerSlab, 1))
+	, m_FreeList(nullptr)
+	, m_LiveCount(0)
+	, m_PeakLiveCount(0) {
+
+	// Alignments are powers of two
+	MIST_ASSERT((m_SlotAlignment & (m_SlotAlignment - 1)) == 0);
+
+	// Free slots hold the free list link, round up to keep every slot aligned
+	slotSize = std::max(slotSize, sizeof(void*));
+	m_SlotSize = (slotSize + m_SlotAlignment - 1) / m_SlotAlignment * m_SlotAlignment;
+}
+
+inline ObjectPool::~ObjectPool() {
+
+	// Slots are still in use, their memory is about to be released
+	MIST_ASSERT(m_LiveCount == 0);
+
+	for (const Slab& slab : m_Slabs) {
+		::operator delete(slab.m_Memory);
+	}
+}
+
+MIST_NAMESPACE_END
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+MIST_NAMESPACE
+
+namespace Detail {
+
+	// Split the [0, count) range into contiguous chunks and run function(begin, end) on each chunk
+	// from the worker pool, the calling thread processes the last chunk.
+	// @Detail: A thread count of 0 uses the hardware concurrency, returns once every chunk is complete.
+	// If chunks throw, the first exception caught is rethrown once the others are complete
+	template< typename FunctionType >
+	void ParallelFor(size_t count, size_t threadCount, FunctionType function);
+
+	// Persistent threads running the chunks of parallel loops, created on first use and joined at exit
+	// so that loops run every frame don't pay for thread creation.
+	// @Detail: A thread waiting for its chunks runs queued chunks itself, parallel loops can be nested
+	// and more chunks than workers can be requested without deadlocking
+	class WorkerPool {
+
+	public:
+
+		// -Public API-
+
+		// Run run(context, chunk) for every chunk in [0, chunkCount) and return once all of them are complete,
+		// the calling thread runs the last chunk
+		// @Detail: Chunks that throw are still counted, the first exception is rethrown once the batch is complete
+		inline void Run(size_t chunkCount, void(*run)(void* context, size_t chunk), void* context);
+
+		inline size_t GetWorkerCount() const;
+
+		// Retrieve the pool shared by the process
+		static inline WorkerPool& Get();
+
+		// -Structors-
+
+		inline explicit WorkerPool(size_t workerCount);
+		inline ~WorkerPool();
+
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+	private:
+
+		// Chunks of a single Run call
+		struct Batch {
+			void(*m_Run)(void*, size_t);
+			void* m_Context;
+			std::atomic<size_t> m_Remaining;
+
+			// First exception thrown by a chunk, written under the pool lock
+			std::exception_ptr m_Exception;
+		};
+
+		struct Task {
+			Batch* m_Batch;
+			size_t m_Chunk;
+		};
+
+		// Run a queued task, the lock is released while the task runs
+		inline void RunTask(std::unique_lock<std::mutex>& lock);
+
+		inline void WorkerLoop();
+
+		std::vector<std::thread> m_Workers;
+		std::deque<Task> m_Tasks;
+		std::mutex m_Lock;
+		std::condition_variable m_TaskAdded;
+		std::condition_variable m_BatchCompleted;
+		bool m_IsStopping;
+	};
+}
+
+
+// -Implementation-
+
+namespace Detail {
+
+	template< typename FunctionType >
+	void ParallelFor(size_t count, size_t threadCount, FunctionType function) {
+
+		if (threadCount == 0) {
+			threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+		}
+		threadCount = std::min(threadCount, count);
+
+		if (threadCount <= 1) {
+			if (count > 0) {
+				function(size_t(0), count);
+			}
+			return;
+		}
+
+		struct Loop {
+			FunctionType* m_Function;
+			size_t m_Count;
+			size_t m_ChunkSize;
+		};
+
+		Loop loop = { &function, count, (count + threadCount - 1) / threadCount };
+		const size_t chunkCount = (count + loop.m_ChunkSize - 1) / loop.m_ChunkSize;
+
+		WorkerPool::Get().Run(chunkCount, [](void* context, size_t chunk) {
+
+			Loop* loop = static_cast<Loop*>(context);
+			const size_t begin = chunk * loop->m_ChunkSize;
+			(*loop->m_Function)(begin, std::min(begin + loop->m_ChunkSize, loop->m_Count));
+		}, &loop);
+	}
+
+	inline void WorkerPool::Run(size_t chunkCount, void(*run)(void*, size_t), void* context) {
+
+		if (chunkCount == 0) {
+			return;
+		}
+
+		Batch batch;
+		batch.m_Run = run;
+		batch.m_Context = context;
+		batch.m_Remaining = chunkCount - 1;
+
+		if (chunkCount > 1) {
+			{
+				std::lock_guard<std::mutex> lock(m_Lock);
+				for (size_t chunk = 0; chunk + 1 < chunkCount; ++chunk) {
+					m_Tasks.push_back({ &batch, chunk });
+				}
+			}
+			m_TaskAdded.notify_all();
+		}
+
+		// The queued tasks reference the batch, it must outlive them even when our chunk throws
+		std::exception_ptr exception;
+		try {
+			run(context, chunkCount - 1);
+		}
+		catch (...) {
+			exception = std::current_exception();
+		}
+
+		// Help with the queued tasks rather than blocking, the remaining chunks may be queued behind other tasks
+		std::unique_lock<std::mutex> lock(m_Lock);
+		if (exception != nullptr && batch.m_Exception == nullptr) {
+			batch.m_Exception = exception;
+		}
+		while (batch.m_Remaining.load(std::memory_order_acquire) > 0) {
+			if (m_Tasks.empty() == false) {
+				RunTask(lock);
+			}
+			else {
+				m_BatchCompleted.wait(lock);
+			}
+		}
+
+		if (batch.m_Exception != nullptr) {
+			std::rethrow_exception(batch.m_Exception);
+		}
+	}
+
+	inline size_t WorkerPool::GetWorkerCount() const {
+
+		return m_Workers.size();
+	}
+
+	inline WorkerPool& WorkerPool::Get() {
+
+		// The calling thread runs a chunk of every loop, one less worker keeps every core busy
+		static WorkerPool pool(std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1);
+		return pool;
+	}
+
+	inline WorkerPool::WorkerPool(size_t workerCount) : m_IsStopping(false) {
+
+		MIST_ASSERT(workerCount > 0);
+
+		m_Workers.reserve(workerCount);
+		for (size_t i = 0; i < workerCount; ++i) {
+			m_Workers.emplace_back([this]() { WorkerLoop(); });
+		}
+	}
+
+	inline WorkerPool::~WorkerPool() {
+
+		{
+			std::lock_guard<std::mutex> lock(m_Lock);
+			m_IsStopping = true;
+		}
+		m_TaskAdded.notify_all();
+
+		for (std::thread& worker : m_Workers) {
+			worker.join();
+		}
+	}
+
+	inline void WorkerPool::RunTask(std::unique_lock<std::mutex>& lock) {
+
+		Task task = m_Tasks.front();
+		m_Tasks.pop_front();
+
+		// Exceptions are handed to the thread running Run, letting them escape would terminate a worker
+		std::exception_ptr exception;
+		lock.unlock();
+		try {
+			task.m_Batch->m_Run(task.m_Batch->m_Context, task.m_Chunk);
+		}
+		catch (...) {
+			exception = std::current_exception();
+		}
+		lock.lock();
+
+		if (exception != nullptr && task.m_Batch->m_Exception == nullptr) {
+			task.m_Batch->m_Exception = exception;
+		}
+
+		// The batch lives on the stack of the thread running Run, it may be gone once the last chunk is counted
+		if (task.m_Batch->m_Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			m_BatchCompleted.notify_all();
+		}
+	}
+
+	inline void WorkerPool::WorkerLoop() {
+
+		std::unique_lock<std::mutex> lock(m_Lock);
+		while (true) {
+			m_TaskAdded.wait(lock, [this]() { return m_IsStopping || m_Tasks.empty() == false; });
+			if (m_Tasks.empty()) {
+				return;
+			}
+			RunTask(lock);
+		}
+	}
+}
+
+MIST_NAMESPACE_END
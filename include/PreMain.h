@@ -1,8 +1,19 @@
 #pragma once
 
 #include "PreMain.h"
+#include "RegistrationProfiler.h"
+#include <cstddef>
 #include <utility>
 
+// Source location of the caller when used as a default argument, unnamed PreMainCalls are profiled under it
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1926)
+#define MIST_CALLER_FILE __builtin_FILE()
+#define MIST_CALLER_LINE static_cast<size_t>(__builtin_LINE())
+#else
+#define MIST_CALLER_FILE "PreMainCall"
+#define MIST_CALLER_LINE size_t(0)
+#endif
+
 MIST_NAMESPACE
 
 // PreMainCall is used to invoke a method before main is
@@ -11,16 +22,34 @@ MIST_NAMESPACE
 class PreMainCall {
 
 public:
+
+	// Unnamed calls are profiled under the file and line of the PreMainCall when MIST_PROFILE_REGISTRATION is enabled
+	// @Detail: file and line default to the location of the caller, leave them to their default
 	template< typename CallType >
-	PreMainCall(CallType call);
+	PreMainCall(CallType call, const char* file = MIST_CALLER_FILE, size_t line = MIST_CALLER_LINE);
+
+	// Named calls are profiled when MIST_PROFILE_REGISTRATION is enabled
+	template< typename CallType >
+	PreMainCall(const char* name, CallType call);
 };
 
 
 // -Implementation-
 
 template< typename CallType >
-PreMainCall::PreMainCall(CallType call) {
-	
+PreMainCall::PreMainCall(CallType call, const char* file, size_t line) {
+
+	MIST_PROFILE_REGISTRATION_SCOPE_AT(file, line);
+	(void)file;
+	(void)line;
+	call();
+}
+
+template< typename CallType >
+PreMainCall::PreMainCall(const char* name, CallType call) {
+
+	MIST_PROFILE_REGISTRATION_SCOPE(name);
+	(void)name;
 	call();
 }
 
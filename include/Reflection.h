@@ -5,13 +5,75 @@
 #include "Any.h"
 #include "GlobalFunction.h"
 #include "GlobalObject.h"
+#include "FrozenTable.h"
+#include "MetaDataIndex.h"
+#include "MemoryStats.h"
+#include "RegistrationProfiler.h"
 #include "../Mist_hashing/include/HashID.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 MIST_NAMESPACE
 
+namespace Detail {
+
+	// Immutable lookup tables published by a Reflection
+	struct ReflectionSnapshot {
+		FrozenTable<TypeInfo> m_Types;
+		FrozenTable<GlobalFunction> m_GlobalFunctions;
+		FrozenTable<GlobalObject> m_GlobalObjects;
+	};
+}
+
+// Entry of a source registry that could not be merged because its name was already taken
+struct MergeConflict {
+
+	enum class Kind {
+		Type,
+		GlobalFunction,
+		GlobalObject,
+		Deferred
+	};
+
+	// Owner index of entries that were already in the destination registry
+	static const size_t DESTINATION = SIZE_MAX;
+
+	Kind m_Kind;
+	HashID::ValueType m_Name;
+
+	// Index of the source registry whose entry was rejected
+	size_t m_Source;
+
+	// Index of the source registry, or DESTINATION, that owns the merged entry of the same name
+	size_t m_Owner;
+};
+
+// Outcome of merging registries
+struct MergeReport {
+
+	std::vector<MergeConflict> m_Conflicts;
+
+	size_t m_MergedTypeCount = 0;
+	size_t m_MergedGlobalFunctionCount = 0;
+	size_t m_MergedGlobalObjectCount = 0;
+	size_t m_MergedDeferredCount = 0;
+
+	inline bool HasConflicts() const { return m_Conflicts.empty() == false; }
+};
+
 // Holds all of the reflection data such as:
 // TypeInfos, GlobalFunctions, GlobalMethods
+// @Detail: Registration is synchronized. Once a snapshot has been published, lookups are wait-free
+// reads of the snapshot and can run on any number of threads while new entries are registered.
+// New entries only become visible to lookups with the next Publish, unless a deferred registration
+// materialized since then, see Defer.
+// Registrations can be deferred until the first lookup of their name to avoid registering unused types.
 class Reflection {
 
 public:
@@ -35,24 +97,165 @@ public:
 
 	inline GlobalObject* GetGlobalObject(HashID name);
 
-	inline std::unordered_map<uint32_t, TypeInfo>* GetTypes();
-	inline std::unordered_map<uint32_t, GlobalFunction>* GetGlobalFunctions();
-	inline std::unordered_map<uint32_t, GlobalObject>* GetGlobalObjects();
+	// -Deferred Registration-
+
+	// Record a registration that runs on the first lookup of name, registration is invoked as void(Reflection*)
+	// and must register name. Recording is cheap, nothing is allocated for the registered entries until then.
+	// @Detail: Registrations are run under the registration lock, publish once the deferred registrations are recorded
+	// in order to look up from multiple threads. Entries materialized after publishing are looked up under the lock
+	// and frozen by their first lookup until the snapshot is republished, which happens once they make up half of it
+	inline void Defer(HashID name, Delegate registration);
+
+	// Defer the registration of the type ClassType, registration is invoked as void(TypeInfo*) with the new type
+	template< typename ClassType, typename RegistrationType >
+	void DeferType(HashID name, RegistrationType registration);
+
+	// Run the deferred registration of name, returns false if none is pending
+	bool Materialize(HashID name);
+
+	// Run every pending deferred registration
+	void MaterializeAll();
+
+	// Retrieve the number of deferred registrations that haven't run yet
+	inline size_t GetDeferredCount() const;
+
+	// Publish every registered entry in a new snapshot, all following lookups go through the latest snapshot
+	// @Detail: Published types are frozen and can't be modified, register a type completely before publishing it.
+	// Pointers retrieved from earlier snapshots stay valid for the lifetime of the Reflection
+	void Publish();
+
+	// Determine if a snapshot has been published
+	inline bool IsPublished() const;
+
+	// Release every snapshot but the latest one, entries retrieved from earlier snapshots stay valid
+	// @Detail: Lookups may still be reading earlier snapshots, only call when no lookup runs concurrently
+	// such as between frames
+	void ReclaimSnapshots();
+
+	// Compact every type, method, member, global and meta data lookup into sorted tables,
+	// all following lookups go through the frozen tables. Call once registration is complete.
+	// @Detail: Runs every deferred registration and publishes a final snapshot, nothing can be registered afterwards
+	void Freeze();
+
+	inline bool IsFrozen() const;
+
+	// Retrieve a counter changed whenever types are added to or moved out of the reflection
+	// @Detail: Used by caches of the registered types to know when to rebuild
+	inline size_t GetTypeGeneration() const;
+
+	// Retrieve a counter changed whenever the structure of the registry may have changed, when types are added or moved
+	// and when constructors, members, methods or meta data are added to the infos of this reflection
+	// @Detail: Used to cache the schema fingerprint, see ComputeSchemaFingerprint
+	inline size_t GetSchemaGeneration() const;
+
+	// -Meta Data Queries-
+
+	// Retrieve every type, method, member, global function and global object whose meta data has key
+	// @Detail: The index is kept up to date as meta data is added, queries don't materialize deferred registrations.
+	// The returned infos are valid until meta data carrying key is added, moved or destroyed,
+	// queries must not run concurrently with registration
+	inline const std::vector<TaggedInfo>& FindTagged(HashID key) const;
+
+	// -Memory-
+
+	// Retrieve the bytes held by the registry per category, see MemoryStats
+	// @Detail: Every entry is walked under the registration lock, don't call it on a hot path
+	MemoryStats GetMemoryStats();
+
+	// Retrieve the memory held by every registered type with its methods and members, largest first
+	std::vector<TypeMemoryStats> GetTypeMemoryStats();
+
+	// Write the bytes per category followed by the typeCount types holding the most memory, 0 writes every type
+	void WriteMemoryReport(std::ostream& stream, size_t typeCount = 0);
+
+	inline std::unordered_map<HashID::ValueType, TypeInfo>* GetTypes();
+	inline std::unordered_map<HashID::ValueType, GlobalFunction>* GetGlobalFunctions();
+	inline std::unordered_map<HashID::ValueType, GlobalObject>* GetGlobalObjects();
+
+	// -Structors-
+
+	inline Reflection();
+
+	Reflection(const Reflection&) = delete;
+	Reflection& operator=(const Reflection&) = delete;
 
 private:
-	std::unordered_map<uint32_t, TypeInfo> m_Types;
-	std::unordered_map<uint32_t, GlobalFunction> m_GlobalFunctions;
-	std::unordered_map<uint32_t, GlobalObject> m_GlobalObjects;
+
+	friend void Merge(Reflection&& left, Reflection* output);
+	friend MergeReport Merge(Reflection* const* sources, size_t sourceCount, Reflection* output, size_t threadCount);
+	friend uint64_t ComputeSchemaFingerprint(Reflection* reflection);
+
+	// Find a registered entry, returns null if the entry isn't registered or published
+	inline TypeInfo* FindType(HashID::ValueType name);
+	inline GlobalFunction* FindGlobalFunction(HashID::ValueType name);
+	inline GlobalObject* FindGlobalObject(HashID::ValueType name);
+
+	// Find an entry registered since the last Publish under the lock, the entry is frozen before it's handed to readers
+	template< typename ValueType >
+	ValueType* FindMaterialized(std::unordered_map<HashID::ValueType, ValueType>* map, HashID::ValueType name);
+
+	// Freeze an entry that hasn't been published yet
+	static inline void FreezeEntry(TypeInfo* type);
+	static inline void FreezeEntry(GlobalFunction* globalFunction);
+	static inline void FreezeEntry(GlobalObject* globalObject);
+
+	// Index the meta data of an entry registered or merged under name, along with its methods and members
+	inline void AttachMetaData(HashID::ValueType name, TypeInfo* type);
+	inline void AttachMetaData(HashID::ValueType name, GlobalFunction* globalFunction);
+	inline void AttachMetaData(HashID::ValueType name, GlobalObject* globalObject);
+
+	// Index of the meta data keys, declared first so that the infos detach from it before it's destroyed
+	Detail::MetaDataIndex m_MetaDataIndex;
+
+	std::unordered_map<HashID::ValueType, TypeInfo> m_Types;
+	std::unordered_map<HashID::ValueType, GlobalFunction> m_GlobalFunctions;
+	std::unordered_map<HashID::ValueType, GlobalObject> m_GlobalObjects;
+
+	// Latest published snapshot, null until the first Publish
+	std::atomic<const Detail::ReflectionSnapshot*> m_Snapshot;
+
+	// Every published snapshot, readers may still be using older snapshots so they're only released by ReclaimSnapshots
+	std::vector<std::unique_ptr<Detail::ReflectionSnapshot>> m_Snapshots;
+
+	// Registrations waiting for the first lookup of their name
+	std::unordered_map<HashID::ValueType, Delegate> m_Deferred;
+	std::atomic<size_t> m_DeferredCount;
+
+	// Registrations materialized since the last Publish, their entries aren't in the snapshot yet
+	std::atomic<size_t> m_MaterializedCount;
+
+	std::atomic<size_t> m_TypeGeneration;
+
+	// Fingerprint of the schema and the schema generation it was computed at, see ComputeSchemaFingerprint
+	uint64_t m_SchemaFingerprint;
+	size_t m_SchemaFingerprintGeneration;
+
+	// Serializes registration and publishing, deferred registrations register while holding the lock
+	std::recursive_mutex m_WriteLock;
+	std::atomic<bool> m_IsFrozen;
 };
 
+// Move every entry of left into output
+// @Detail: Names must not collide, use the multi source Merge to retrieve the conflicts instead
 void Merge(Reflection&& left, Reflection* output);
 
+// Move the entries of every source into output, the destination is sized once for all of the sources
+// and name collisions are detected across threadCount threads, 0 uses the hardware concurrency.
+// @Detail: The first entry of a name wins, entries already in output take precedence over the sources
+// and earlier sources over later ones. Rejected entries are reported and left in their source.
+// Deferred registrations are moved as is and run on the first lookup in output
+// The merged entries become visible to lookups with the next Publish of output
+MergeReport Merge(Reflection* const* sources, size_t sourceCount, Reflection* output, size_t threadCount = 0);
+
 
 // -Implementation-
 
 template< typename ClassType >
 TypeInfo* Reflection::AddType(HashID name) {
 
+	std::lock_guard<std::recursive_mutex> lock(m_WriteLock);
+	MIST_ASSERT(m_IsFrozen == false);
+
 	Type classType;
 	classType.DefineTypes<ClassType>();
 
@@ -61,60 +264,270 @@ TypeInfo* Reflection::AddType(HashID name) {
 	auto result = m_Types.emplace(name.GetValue(), std::move(type));
 
 	MIST_ASSERT(result.second);
+	MIST_PROFILE_REGISTRATION_COUNT(m_TypeCount);
 
+	m_TypeGeneration.fetch_add(1, std::memory_order_release);
+	AttachMetaData(name.GetValue(), &result.first->second);
 	return &result.first->second;
 }
 
 inline TypeInfo* Reflection::GetType(HashID name) {
 
-	return &m_Types.at(name.GetValue());
+	TypeInfo* found = FindType(name.GetValue());
+	if (found == nullptr) {
+
+		// Another thread may be running the registration, which is complete once Materialize returns
+		Materialize(name);
+		found = FindType(name.GetValue());
+	}
+
+	// The entry doesn't exist or hasn't been published yet
+	MIST_ASSERT(found != nullptr);
+	return found;
+}
+
+inline TypeInfo* Reflection::FindType(HashID::ValueType name) {
+
+	const Detail::ReflectionSnapshot* snapshot = m_Snapshot.load(std::memory_order_acquire);
+	if (snapshot != nullptr) {
+		TypeInfo* found = snapshot->m_Types.Find(name);
+		if (found != nullptr || m_MaterializedCount.load(std::memory_order_acquire) == 0) {
+			return found;
+		}
+		return FindMaterialized(&m_Types, name);
+	}
+
+	auto found = m_Types.find(name);
+	return found != m_Types.end() ? &found->second : nullptr;
 }
 
 
 template< typename ReturnType, typename... Arguments >
 GlobalFunction* Reflection::AddGlobalFunction(HashID name, ReturnType(*function)(Arguments...)) {
 
+	std::lock_guard<std::recursive_mutex> lock(m_WriteLock);
+	MIST_ASSERT(m_IsFrozen == false);
+
 	auto result = m_GlobalFunctions.emplace(name.GetValue(), function);
 
 	MIST_ASSERT(result.second);
+	MIST_PROFILE_REGISTRATION_COUNT(m_GlobalFunctionCount);
+
+	AttachMetaData(name.GetValue(), &result.first->second);
 
 	return &result.first->second;
 }
 
 inline GlobalFunction* Reflection::GetGlobalFunction(HashID name) {
 
-	return &m_GlobalFunctions.at(name.GetValue());
+	GlobalFunction* found = FindGlobalFunction(name.GetValue());
+	if (found == nullptr) {
+
+		// Another thread may be running the registration, which is complete once Materialize returns
+		Materialize(name);
+		found = FindGlobalFunction(name.GetValue());
+	}
+
+	// The entry doesn't exist or hasn't been published yet
+	MIST_ASSERT(found != nullptr);
+	return found;
+}
+
+inline GlobalFunction* Reflection::FindGlobalFunction(HashID::ValueType name) {
+
+	const Detail::ReflectionSnapshot* snapshot = m_Snapshot.load(std::memory_order_acquire);
+	if (snapshot != nullptr) {
+		GlobalFunction* found = snapshot->m_GlobalFunctions.Find(name);
+		if (found != nullptr || m_MaterializedCount.load(std::memory_order_acquire) == 0) {
+			return found;
+		}
+		return FindMaterialized(&m_GlobalFunctions, name);
+	}
+
+	auto found = m_GlobalFunctions.find(name);
+	return found != m_GlobalFunctions.end() ? &found->second : nullptr;
 }
 
 
 template< typename ObjectType >
 GlobalObject* Reflection::AddGlobalObject(HashID name, ObjectType* object) {
 
+	std::lock_guard<std::recursive_mutex> lock(m_WriteLock);
+	MIST_ASSERT(m_IsFrozen == false);
+
 	auto result = m_GlobalObjects.emplace(name.GetValue(), GlobalObject(object));
 
 	MIST_ASSERT(result.second);
+	MIST_PROFILE_REGISTRATION_COUNT(m_GlobalObjectCount);
+
+	AttachMetaData(name.GetValue(), &result.first->second);
 
 	return &result.first->second;
 }
 
 inline GlobalObject* Reflection::GetGlobalObject(HashID name) {
 
-	return &m_GlobalObjects.at(name.GetValue());
+	GlobalObject* found = FindGlobalObject(name.GetValue());
+	if (found == nullptr) {
+
+		// Another thread may be running the registration, which is complete once Materialize returns
+		Materialize(name);
+		found = FindGlobalObject(name.GetValue());
+	}
+
+	// The entry doesn't exist or hasn't been published yet
+	MIST_ASSERT(found != nullptr);
+	return found;
+}
+
+inline GlobalObject* Reflection::FindGlobalObject(HashID::ValueType name) {
+
+	const Detail::ReflectionSnapshot* snapshot = m_Snapshot.load(std::memory_order_acquire);
+	if (snapshot != nullptr) {
+		GlobalObject* found = snapshot->m_GlobalObjects.Find(name);
+		if (found != nullptr || m_MaterializedCount.load(std::memory_order_acquire) == 0) {
+			return found;
+		}
+		return FindMaterialized(&m_GlobalObjects, name);
+	}
+
+	auto found = m_GlobalObjects.find(name);
+	return found != m_GlobalObjects.end() ? &found->second : nullptr;
+}
+
+template< typename ValueType >
+ValueType* Reflection::FindMaterialized(std::unordered_map<HashID::ValueType, ValueType>* map, HashID::ValueType name) {
+
+	std::lock_guard<std::recursive_mutex> lock(m_WriteLock);
+
+	auto found = map->find(name);
+	if (found == map->end()) {
+		return nullptr;
+	}
+	FreezeEntry(&found->second);
+	return &found->second;
+}
+
+inline void Reflection::FreezeEntry(TypeInfo* type) {
+
+	if (type->IsFrozen() == false) {
+		type->Freeze();
+	}
+}
+
+inline void Reflection::FreezeEntry(GlobalFunction* globalFunction) {
+
+	if (globalFunction->GetMetaData()->IsFrozen() == false) {
+		globalFunction->GetMetaData()->Freeze();
+	}
+}
+
+inline void Reflection::FreezeEntry(GlobalObject* globalObject) {
+
+	if (globalObject->GetMetaData()->IsFrozen() == false) {
+		globalObject->GetMetaData()->Freeze();
+	}
+}
+
+inline void Reflection::Defer(HashID name, Delegate registration) {
+
+	// Registrations are invoked as void(Reflection*)
+	MIST_ASSERT((registration.HasSignature<void, Reflection*>()));
+
+	std::lock_guard<std::recursive_mutex> lock(m_WriteLock);
+	MIST_ASSERT(m_IsFrozen == false);
+
+	auto result = m_Deferred.emplace(name.GetValue(), std::move(registration));
+
+	// A registration was already deferred under this name
+	MIST_ASSERT(result.second);
+	if (result.second) {
+		++m_DeferredCount;
+	}
 }
 
-inline std::unordered_map<uint32_t, TypeInfo>* Reflection::GetTypes() {
+template< typename ClassType, typename RegistrationType >
+void Reflection::DeferType(HashID name, RegistrationType registration) {
+
+	Defer(name, Delegate([name, registration](Reflection* reflection) {
+		registration(reflection->AddType<ClassType>(name));
+	}));
+}
+
+inline size_t Reflection::GetDeferredCount() const {
+
+	return m_DeferredCount.load(std::memory_order_acquire);
+}
+
+inline bool Reflection::IsPublished() const {
+
+	return m_Snapshot.load(std::memory_order_acquire) != nullptr;
+}
+
+inline bool Reflection::IsFrozen() const {
+
+	return m_IsFrozen;
+}
+
+inline size_t Reflection::GetTypeGeneration() const {
+
+	return m_TypeGeneration.load(std::memory_order_acquire);
+}
+
+inline size_t Reflection::GetSchemaGeneration() const {
+
+	// Both counters only grow, their sum changes whenever one of them does
+	return GetTypeGeneration() + m_MetaDataIndex.GetGeneration();
+}
+
+inline const std::vector<TaggedInfo>& Reflection::FindTagged(HashID key) const {
+
+	return m_MetaDataIndex.Find(key.GetValue());
+}
+
+inline void Reflection::AttachMetaData(HashID::ValueType name, TypeInfo* type) {
+
+	m_MetaDataIndex.Attach(type->GetMetaData(), { TaggedInfo::Kind::Type, name, type, nullptr });
+	for (auto& method : *type->GetMethods()) {
+		m_MetaDataIndex.Attach(method.second.GetMetaData(), { TaggedInfo::Kind::Method, method.first, &method.second, type });
+	}
+	for (auto& member : *type->GetMembers()) {
+		m_MetaDataIndex.Attach(member.second.GetMetaData(), { TaggedInfo::Kind::Member, member.first, &member.second, type });
+	}
+}
+
+inline void Reflection::AttachMetaData(HashID::ValueType name, GlobalFunction* globalFunction) {
+
+	m_MetaDataIndex.Attach(globalFunction->GetMetaData(), { TaggedInfo::Kind::GlobalFunction, name, globalFunction, nullptr });
+}
+
+inline void Reflection::AttachMetaData(HashID::ValueType name, GlobalObject* globalObject) {
+
+	m_MetaDataIndex.Attach(globalObject->GetMetaData(), { TaggedInfo::Kind::GlobalObject, name, globalObject, nullptr });
+}
+
+inline std::unordered_map<HashID::ValueType, TypeInfo>* Reflection::GetTypes() {
 
 	return &m_Types;
 }
 
-inline std::unordered_map<uint32_t, GlobalFunction>* Reflection::GetGlobalFunctions() {
+inline std::unordered_map<HashID::ValueType, GlobalFunction>* Reflection::GetGlobalFunctions() {
 
 	return &m_GlobalFunctions;
 }
 
-inline std::unordered_map<uint32_t, GlobalObject>* Reflection::GetGlobalObjects() {
+inline std::unordered_map<HashID::ValueType, GlobalObject>* Reflection::GetGlobalObjects() {
 
 	return &m_GlobalObjects;
 }
 
+inline Reflection::Reflection()
+	: m_Snapshot(nullptr)
+	, m_DeferredCount(0)
+	, m_MaterializedCount(0)
+	, m_TypeGeneration(0)
+	, m_SchemaFingerprint(0)
+	, m_SchemaFingerprintGeneration(SIZE_MAX)
+	, m_IsFrozen(false) {}
+
 MIST_NAMESPACE_END
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+// Define as 1 to time every named PreMainCall and deferred registration and count what it registered
+#ifndef MIST_PROFILE_REGISTRATION
+#define MIST_PROFILE_REGISTRATION 0
+#endif
+
+// Define as 1 alongside MIST_PROFILE_REGISTRATION to replace the global operator new and delete
+// and attribute the allocated bytes to the running registration
+#ifndef MIST_PROFILE_REGISTRATION_ALLOCATIONS
+#define MIST_PROFILE_REGISTRATION_ALLOCATIONS 0
+#endif
+
+#if MIST_PROFILE_REGISTRATION
+#define MIST_PROFILE_REGISTRATION_COUNT(counter) (++::Mist::Detail::GetRegistrationCounters().counter)
+#define MIST_PROFILE_REGISTRATION_SCOPE(name) ::Mist::RegistrationScope registrationScope(name)
+#define MIST_PROFILE_REGISTRATION_SCOPE_AT(file, line) ::Mist::RegistrationScope registrationScope(file, line)
+#else
+#define MIST_PROFILE_REGISTRATION_COUNT(counter) ((void)0)
+#define MIST_PROFILE_REGISTRATION_SCOPE(name) ((void)0)
+#define MIST_PROFILE_REGISTRATION_SCOPE_AT(file, line) ((void)0)
+#endif
+
+MIST_NAMESPACE
+
+// Counts of what a registration added to the reflection data
+struct RegistrationCounters {
+	size_t m_TypeCount = 0;
+	size_t m_MethodCount = 0;
+	size_t m_MemberCount = 0;
+	size_t m_MetaDataCount = 0;
+	size_t m_GlobalFunctionCount = 0;
+	size_t m_GlobalObjectCount = 0;
+	size_t m_AllocatedBytes = 0;
+	size_t m_AllocationCount = 0;
+};
+
+// Profile of a single registration callback
+// @Detail: Counts include the nested registrations run by the callback
+struct RegistrationRecord {
+	const char* m_Name;
+
+	// Line of the registration when it's named by its source location, m_Name is then the file. 0 for named registrations
+	size_t m_Line;
+
+	size_t m_ThreadId;
+	size_t m_Depth;
+	uint64_t m_StartNanoseconds;
+	uint64_t m_DurationNanoseconds;
+	RegistrationCounters m_Counters;
+};
+
+// RegistrationProfiler collects a record for every profiled registration of the process
+// @Detail: Records are only collected when MIST_PROFILE_REGISTRATION is enabled, allocations are only
+// counted when MIST_PROFILE_REGISTRATION_ALLOCATIONS is enabled as well. Record names must outlive the profiler.
+class RegistrationProfiler {
+
+public:
+
+	// -Public API-
+
+	// Start profiling a registration on the calling thread, registrations can be nested
+	// @Detail: A non zero line names the registration by its source location, name is then the file
+	static void Begin(const char* name, size_t line = 0);
+
+	// Complete the last registration started on the calling thread
+	static void End();
+
+	// Retrieve a copy of every completed record in completion order
+	static std::vector<RegistrationRecord> GetRecords();
+
+	static void Clear();
+
+	// Write a table of the records sorted by duration, most expensive first
+	static void WriteReport(std::ostream& stream);
+
+	// Write the records as a Chrome trace, viewable in chrome://tracing or Perfetto
+	static void WriteChromeTrace(std::ostream& stream);
+};
+
+// Profile a registration for the lifetime of the scope
+class RegistrationScope {
+
+public:
+
+	// -Structors-
+
+	explicit RegistrationScope(const char* name, size_t line = 0) { RegistrationProfiler::Begin(name, line); }
+	~RegistrationScope() { RegistrationProfiler::End(); }
+
+	RegistrationScope(const RegistrationScope&) = delete;
+	RegistrationScope& operator=(const RegistrationScope&) = delete;
+};
+
+namespace Detail {
+
+	// Running counts of the calling thread, registrations record the difference between their beginning and end
+	inline RegistrationCounters& GetRegistrationCounters() {
+
+		static thread_local RegistrationCounters counters;
+		return counters;
+	}
+}
+
+MIST_NAMESPACE_END
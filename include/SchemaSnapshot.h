@@ -0,0 +1,250 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include "../Mist_hashing/include/HashID.h"
+#include "TypeId.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+MIST_NAMESPACE
+
+class Reflection;
+
+// Records of a schema snapshot, every record is laid out without padding and read in place from the snapshot.
+// Names are the HashID values the entries were registered with, type hashes are stable hashes of TypeId names.
+// Child records are sorted by name and referenced by their range in the table of their kind.
+
+struct SchemaType {
+	uint64_t m_Name;
+	uint64_t m_TypeHash;
+	uint64_t m_Size;
+	uint64_t m_Alignment;
+
+	// Offset of the TypeId name in the string table
+	uint32_t m_TypeName;
+
+	uint32_t m_FirstMember;
+	uint32_t m_MemberCount;
+	uint32_t m_FirstMethod;
+	uint32_t m_MethodCount;
+	uint32_t m_FirstMetaData;
+	uint32_t m_MetaDataCount;
+	uint32_t m_Reserved;
+};
+
+struct SchemaMember {
+
+	// Offset of members without a byte offset
+	static const uint64_t NO_OFFSET = UINT64_MAX;
+
+	uint64_t m_Name;
+	uint64_t m_TypeHash;
+	uint64_t m_Offset;
+	uint64_t m_Size;
+	uint64_t m_Alignment;
+
+	// Offset of the member name in the string table, the empty string if it was registered with a HashID
+	uint32_t m_MemberName;
+
+	uint32_t m_FirstMetaData;
+	uint32_t m_MetaDataCount;
+	uint32_t m_Reserved;
+};
+
+struct SchemaMethod {
+	uint64_t m_Name;
+	uint64_t m_SignatureHash;
+
+	// Offset of the TypeId name of the signature in the string table
+	uint32_t m_Signature;
+
+	uint32_t m_FirstMetaData;
+	uint32_t m_MetaDataCount;
+	uint32_t m_Reserved;
+};
+
+struct SchemaMetaData {
+
+	// Data offset of values that can't be copied bytewise, only their type is recorded
+	static const uint64_t NO_DATA = UINT64_MAX;
+
+	uint64_t m_Name;
+	uint64_t m_TypeHash;
+	uint64_t m_DataOffset;
+	uint64_t m_Size;
+};
+
+namespace Detail {
+
+	const uint32_t SCHEMA_MAGIC = 0x4843534D;
+	const uint32_t SCHEMA_VERSION = 1;
+
+	struct SchemaHeader {
+		uint32_t m_Magic;
+		uint32_t m_Version;
+
+		// Size of HashID values and of pointers of the process that wrote the snapshot
+		uint32_t m_HashIdSize;
+		uint32_t m_PointerSize;
+
+		// Hash of every record and string, data of the meta data excluded
+		uint64_t m_Fingerprint;
+		uint64_t m_FileSize;
+
+		uint32_t m_TypeCount;
+		uint32_t m_MemberCount;
+		uint32_t m_MethodCount;
+		uint32_t m_MetaDataCount;
+
+		uint64_t m_TypesOffset;
+		uint64_t m_MembersOffset;
+		uint64_t m_MethodsOffset;
+		uint64_t m_MetaDataOffset;
+		uint64_t m_StringsOffset;
+		uint64_t m_DataOffset;
+	};
+
+	// Stable hash of a type, TypeId values are only stable for the lifetime of the process
+	inline uint64_t SchemaTypeHash(TypeId type);
+}
+
+// Serialize the structure of every type of the reflection into a snapshot: type names and hashes, member layouts,
+// method signatures and meta data. Meta data values that can be copied bytewise are stored along with their type.
+// @Detail: Deferred registrations are materialized first. Returns false if the file couldn't be written
+bool WriteSchemaSnapshot(Reflection* reflection, const char* path);
+
+// Compute the fingerprint a snapshot of the reflection would have, used to validate snapshots against the live registry
+// @Detail: Deferred registrations are part of the schema and are materialized first. The fingerprint is cached
+// on the reflection and only recomputed once its schema generation changed, see Reflection::GetSchemaGeneration
+uint64_t ComputeSchemaFingerprint(Reflection* reflection);
+
+// SchemaSnapshot memory maps a snapshot written by WriteSchemaSnapshot and looks entries up in place,
+// no maps are built when a snapshot is opened.
+// @Detail: Snapshots are only valid for builds with the same layouts, compare the fingerprint with the live registry
+// through Matches to reject stale snapshots. Returned records point into the mapping and are valid until Close.
+class SchemaSnapshot {
+
+public:
+
+	// -Public API-
+
+	// Map a snapshot file, false if the file can't be mapped or isn't a snapshot of this version
+	bool Open(const char* path);
+
+	// View a snapshot held in memory, the memory must outlive the view and be 8 byte aligned
+	bool Open(const void* data, size_t size);
+
+	void Close();
+
+	bool IsOpen() const;
+
+	uint64_t GetFingerprint() const;
+
+	// Determine if the snapshot describes the live reflection, compares with the cached fingerprint of the reflection
+	bool Matches(Reflection* reflection) const;
+	bool Matches(uint64_t fingerprint) const;
+
+	// -Types-
+
+	const SchemaType* FindType(HashID name) const;
+
+	const SchemaType* GetTypes() const;
+	size_t GetTypeCount() const;
+
+	// -Children-
+
+	const SchemaMember* FindMember(const SchemaType& type, HashID name) const;
+	const SchemaMember* GetMembers(const SchemaType& type) const;
+
+	const SchemaMethod* FindMethod(const SchemaType& type, HashID name) const;
+	const SchemaMethod* GetMethods(const SchemaType& type) const;
+
+	// Find the meta data of a type, member or method
+	template< typename RecordType >
+	const SchemaMetaData* FindMetaData(const RecordType& record, HashID name) const;
+
+	template< typename RecordType >
+	const SchemaMetaData* GetMetaData(const RecordType& record) const;
+
+	// Copy a meta data value out of the snapshot
+	// @Detail: Returns false if the value was stored with another type or couldn't be copied bytewise
+	template< typename Type >
+	bool ReadMetaData(const SchemaMetaData& metaData, Type* value) const;
+
+	// Retrieve a string of the string table
+	const char* GetString(uint32_t offset) const;
+
+	// -Structors-
+
+	SchemaSnapshot();
+	~SchemaSnapshot();
+
+	SchemaSnapshot(const SchemaSnapshot&) = delete;
+	SchemaSnapshot& operator=(const SchemaSnapshot&) = delete;
+
+private:
+
+	// Validate the header and the ranges of the records, false if the snapshot is malformed or stale
+	bool Validate();
+
+	const SchemaMetaData* FindMetaData(uint32_t first, uint32_t count, HashID name) const;
+
+	template< typename RecordType >
+	const RecordType* GetTable(uint64_t offset) const;
+
+	const unsigned char* m_Data;
+	size_t m_Size;
+	const Detail::SchemaHeader* m_Header;
+
+	// Platform handles of the mapping, null when viewing memory
+	void* m_Mapping;
+	void* m_File;
+};
+
+
+// -Implementation-
+
+template< typename RecordType >
+const SchemaMetaData* SchemaSnapshot::FindMetaData(const RecordType& record, HashID name) const {
+
+	return FindMetaData(record.m_FirstMetaData, record.m_MetaDataCount, name);
+}
+
+template< typename RecordType >
+const SchemaMetaData* SchemaSnapshot::GetMetaData(const RecordType& record) const {
+
+	return GetTable<SchemaMetaData>(m_Header->m_MetaDataOffset) + record.m_FirstMetaData;
+}
+
+template< typename Type >
+bool SchemaSnapshot::ReadMetaData(const SchemaMetaData& metaData, Type* value) const {
+
+	static_assert(std::is_trivially_copyable<Type>::value, "Only values copyable bytewise are stored in snapshots");
+
+	if (metaData.m_DataOffset == SchemaMetaData::NO_DATA || metaData.m_Size != sizeof(Type)
+		|| metaData.m_TypeHash != Detail::SchemaTypeHash(TypeId::Get<Type>())) {
+		return false;
+	}
+
+	std::memcpy(value, m_Data + m_Header->m_DataOffset + metaData.m_DataOffset, sizeof(Type));
+	return true;
+}
+
+template< typename RecordType >
+const RecordType* SchemaSnapshot::GetTable(uint64_t offset) const {
+
+	return reinterpret_cast<const RecordType*>(m_Data + offset);
+}
+
+namespace Detail {
+
+	inline uint64_t SchemaTypeHash(TypeId type) {
+
+		const char* name = type.GetName();
+		return djb2::Hash<uint64_t>(name, std::strlen(name));
+	}
+}
+
+MIST_NAMESPACE_END
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include "Delegate.h"
+#include "LayoutBuilder.h"
+#include "TypeId.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+MIST_NAMESPACE
+
+namespace Detail {
+
+	// Hash and equality functions of a type that can't be compared bytewise
+	struct StructuralFunctions {
+
+		// uint64_t(const void* object)
+		Delegate m_Hash;
+
+		// bool(const void* left, const void* right)
+		Delegate m_Equals;
+	};
+}
+
+// StructuralHasher hashes and compares reflected objects through their reflected members, in sync with the registrations.
+// The layout of a type is built once on first use: runs of adjacent members that can be compared bytewise are hashed
+// and compared as a single block, the walk only recurses into members that need functions or member pointers.
+// @Detail: Only reflected members take part, padding is never read. Bytewise members are compared by their bits:
+// 0.0 and -0.0 differ and a NaN equals itself. Members that are neither reflected nor free of padding need functions,
+// std::string has functions by default. A type that can't be laid out asserts, hashes to 0 and is never equal.
+// Hashes are only stable between processes with the same layouts. Layouts reference the type infos of the reflection,
+// every nested type must be registered (and materialized if deferred) before its first use.
+// The hasher isn't thread safe, use one per thread.
+class StructuralHasher {
+
+public:
+
+	// -Public API-
+
+	template< typename Type >
+	uint64_t Hash(const Type& object);
+
+	uint64_t Hash(const void* object, TypeInfo* type);
+
+	// Determine if every reflected member of the objects is equal
+	template< typename Type >
+	bool Equals(const Type& left, const Type& right);
+
+	bool Equals(const void* left, const void* right, TypeInfo* type);
+
+	// Register the functions hashing and comparing a type that isn't reflected or free of padding
+	// @Detail: Functions must be added before the first layout that uses the type is built
+	template< typename Type >
+	void AddFunctions(uint64_t(*hash)(const Type& object), bool(*equals)(const Type& left, const Type& right));
+
+	// -Structors-
+
+	explicit StructuralHasher(Reflection* reflection);
+
+	StructuralHasher(const StructuralHasher&) = delete;
+	StructuralHasher& operator=(const StructuralHasher&) = delete;
+
+private:
+
+	uint64_t HashLayout(const Detail::Layout& layout, const unsigned char* object);
+	bool EqualsLayout(const Detail::Layout& layout, const unsigned char* left, const unsigned char* right);
+
+	Detail::LayoutBuilder m_Layouts;
+	std::unordered_map<TypeId, std::unique_ptr<Detail::StructuralFunctions>> m_Functions;
+};
+
+
+// -Implementation-
+
+template< typename Type >
+uint64_t StructuralHasher::Hash(const Type& object) {
+
+	const Detail::Layout* layout = m_Layouts.Get(TypeId::Get<Type>());
+	return layout != nullptr ? HashLayout(*layout, reinterpret_cast<const unsigned char*>(&object)) : 0;
+}
+
+template< typename Type >
+bool StructuralHasher::Equals(const Type& left, const Type& right) {
+
+	const Detail::Layout* layout = m_Layouts.Get(TypeId::Get<Type>());
+	return layout != nullptr && EqualsLayout(*layout, reinterpret_cast<const unsigned char*>(&left), reinterpret_cast<const unsigned char*>(&right));
+}
+
+template< typename Type >
+void StructuralHasher::AddFunctions(uint64_t(*hash)(const Type&), bool(*equals)(const Type&, const Type&)) {
+
+	MIST_ASSERT(hash != nullptr && equals != nullptr);
+
+	std::unique_ptr<Detail::StructuralFunctions> functions(new Detail::StructuralFunctions{
+		Delegate([hash](const void* object) { return hash(*static_cast<const Type*>(object)); }),
+		Delegate([equals](const void* left, const void* right) { return equals(*static_cast<const Type*>(left), *static_cast<const Type*>(right)); })
+	});
+	m_Layouts.AddCustom(TypeId::Get<Type>(), functions.get());
+	m_Functions[TypeId::Get<Type>()] = std::move(functions);
+}
+
+MIST_NAMESPACE_END
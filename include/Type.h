@@ -1,15 +1,11 @@
 #pragma once
 
 #include <Mist_Common/include/UtilityMacros.h>
-#include <memory>
+#include "TypeId.h"
 #include <utility>
 
 MIST_NAMESPACE
 
-namespace Detail {
-	class TypeContainer;
-}
-
 // The type class is a class that holds compile time type information that can be queried
 // Using the Is method, the Type class can be held in a container with other Types
 class Type {
@@ -29,6 +25,9 @@ public:
 	template< typename... CoreTypes >
 	bool Is() const;
 
+	// Retrieve the identity token of the core types
+	inline TypeId GetId() const;
+
 	// -Structors-
 
 	Type() = default;
@@ -42,47 +41,36 @@ public:
 
 private:
 	
-	std::unique_ptr<Detail::TypeContainer> m_Types;
+	TypeId m_Types;
 };
 
-namespace Detail {
-
-	// Define a base class for the type data in order to
-	// hold it homogenously
-	class TypeContainer {
-	public:
-		virtual ~TypeContainer() = default;
-	};
-
-	// Define the derived class that actually holds the type data
-	template< typename... Types >
-	class TypeDeclarations : public TypeContainer {};
-}
-
 // -Implementation-
 
 template< typename... CoreTypes >
 bool Type::Is() const {
 	// Please invoke Type::DefineTypes before calling Is
-	MIST_ASSERT(m_Types != nullptr);
+	MIST_ASSERT(m_Types.IsValid());
 
-	Detail::TypeContainer* type = m_Types.get();
-	// Try to dynamically cast it, if it doesn't return null, that means
-	// it is the definition of those types
-	return dynamic_cast<Detail::TypeDeclarations<CoreTypes...>*>(type) != nullptr;
+	return m_Types == TypeId::Get<CoreTypes...>();
 }
 
 template< typename... CoreTypes >
 void Type::DefineTypes() {
-	m_Types.reset(new Detail::TypeDeclarations<CoreTypes...>());
+	m_Types = TypeId::Get<CoreTypes...>();
+}
+
+TypeId Type::GetId() const {
+	return m_Types;
 }
 
 Type::Type(Type&& move) {
-	m_Types = std::move(move.m_Types);
+	m_Types = move.m_Types;
+	move.m_Types = TypeId();
 }
 
 Type& Type::operator=(Type&& move) {
-	m_Types = std::move(move.m_Types);
+	m_Types = move.m_Types;
+	move.m_Types = TypeId();
 	return *this;
 }
 
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+MIST_NAMESPACE
+
+namespace Detail {
+	struct TypeIdEntry;
+}
+
+// TypeId is a lightweight identity token for a compile time list of types.
+// Two ids are equal only if they were created from the same types, comparing them is a single pointer compare.
+// @Detail: TypeId does not rely on RTTI and can be used when building with RTTI disabled.
+// Ids are unique within a module, types shared across dynamic library boundaries may receive one id per module.
+class TypeId {
+
+public:
+
+	// -Public API-
+
+	// Retrieve the id of the types
+	// @Detail: Use a function type such as ReturnType(Arguments...) to identify a signature
+	template< typename... Types >
+	static constexpr TypeId Get();
+
+	// Determine if the id was created from a type list
+	inline bool IsValid() const;
+
+	// Retrieve a compiler generated description of the types, only meant for diagnostics
+	inline const char* GetName() const;
+
+	// Retrieve the id as an integer, the value is only stable for the lifetime of the process
+	inline uintptr_t GetValue() const;
+
+	inline bool operator==(TypeId other) const;
+	inline bool operator!=(TypeId other) const;
+	inline bool operator<(TypeId other) const;
+
+	// -Structors-
+
+	// Initialize to an invalid id
+	constexpr TypeId() : m_Entry(nullptr) {}
+
+private:
+
+	constexpr explicit TypeId(const Detail::TypeIdEntry* entry) : m_Entry(entry) {}
+
+	const Detail::TypeIdEntry* m_Entry;
+};
+
+
+namespace Detail {
+
+	struct TypeIdEntry {
+		const char* (*m_Name)();
+	};
+
+	// Every instantiation owns one entry, the address of the entry is the identity of the types
+	template< typename... Types >
+	struct TypeIdStorage {
+
+		static const char* Name();
+
+		static const TypeIdEntry s_Entry;
+	};
+
+	template< typename... Types >
+	const TypeIdEntry TypeIdStorage<Types...>::s_Entry = { &TypeIdStorage<Types...>::Name };
+}
+
+// -Implementation-
+
+template< typename... Types >
+constexpr TypeId TypeId::Get() {
+
+	return TypeId(&Detail::TypeIdStorage<Types...>::s_Entry);
+}
+
+inline bool TypeId::IsValid() const {
+
+	return m_Entry != nullptr;
+}
+
+inline const char* TypeId::GetName() const {
+
+	return m_Entry != nullptr ? m_Entry->m_Name() : "";
+}
+
+inline uintptr_t TypeId::GetValue() const {
+
+	return reinterpret_cast<uintptr_t>(m_Entry);
+}
+
+inline bool TypeId::operator==(TypeId other) const {
+
+	return m_Entry == other.m_Entry;
+}
+
+inline bool TypeId::operator!=(TypeId other) const {
+
+	return m_Entry != other.m_Entry;
+}
+
+inline bool TypeId::operator<(TypeId other) const {
+
+	return std::less<const Detail::TypeIdEntry*>()(m_Entry, other.m_Entry);
+}
+
+namespace Detail {
+
+	template< typename... Types >
+	const char* TypeIdStorage<Types...>::Name() {
+
+#if defined(_MSC_VER)
+		return __FUNCSIG__;
+#else
+		return __PRETTY_FUNCTION__;
+#endif
+	}
+}
+
+MIST_NAMESPACE_END
+
+namespace std {
+
+	template<>
+	struct hash<Mist::TypeId> {
+
+		size_t operator()(Mist::TypeId id) const {
+			return std::hash<uintptr_t>()(id.GetValue());
+		}
+	};
+}
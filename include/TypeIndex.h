@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Mist_Common/include/UtilityMacros.h>
+#include "Reflection.h"
+#include "TypeId.h"
+#include <unordered_map>
+
+MIST_NAMESPACE
+
+namespace Detail {
+
+	// Index of the types of a reflection by their TypeId, used to recurse into reflected members
+	// @Detail: The index is rebuilt when the type generation of the reflection changed since it was built,
+	// it must not outlive the reflection
+	class TypeIndex {
+
+	public:
+
+		// -Public API-
+
+		// Retrieve the type info of a type, null if the type isn't reflected
+		inline TypeInfo* Find(TypeId type);
+
+		// -Structors-
+
+		inline explicit TypeIndex(Reflection* reflection);
+
+	private:
+
+		Reflection* m_Reflection;
+		std::unordered_map<TypeId, TypeInfo*> m_TypeInfos;
+
+		// Type generation of the reflection the index was built at
+		size_t m_Generation;
+	};
+
+
+	// -Implementation-
+
+	inline TypeInfo* TypeIndex::Find(TypeId type) {
+
+		// Types moved by a Merge leave the count unchanged, the generation changes with every move
+		const size_t generation = m_Reflection->GetTypeGeneration();
+		if (generation != m_Generation) {
+
+			m_Generation = generation;
+			m_TypeInfos.clear();
+			for (auto& typeInfo : *m_Reflection->GetTypes()) {
+				m_TypeInfos.emplace(typeInfo.second.GetTypeId(), &typeInfo.second);
+			}
+		}
+
+		auto found = m_TypeInfos.find(type);
+		return found != m_TypeInfos.end() ? found->second : nullptr;
+	}
+
+	inline TypeIndex::TypeIndex(Reflection* reflection)
+		: m_Reflection(reflection)
+		, m_Generation(0) {
+
+		MIST_ASSERT(reflection != nullptr);
+	}
+}
+
+MIST_NAMESPACE_END
@@ -2,9 +2,17 @@
 
 #include <Mist_Common/include/UtilityMacros.h>
 #include "../Mist_hashing/include/HashID.h"
+#include "Type.h"
 #include "MemberInfo.h"
 #include "MethodInfo.h"
 #include "MetaData.h"
+#include "FrozenTable.h"
+#include "ObjectPool.h"
+#include "RegistrationProfiler.h"
+#include "TypeId.h"
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <unordered_map>
 #include <vector>
 #include <cstdint>
@@ -12,6 +20,15 @@
 
 MIST_NAMESPACE
 
+namespace Detail {
+
+	// Constructor registered for one signature, both allocating and constructing in caller provided memory
+	struct ConstructorEntry {
+		Delegate m_Create;
+		Delegate m_CreateAt;
+	};
+}
+
 // TypeInfo is the core reflection class associated to the
 // types, this class holds all of the member and method infos
 class TypeInfo {
@@ -22,23 +39,67 @@ public:
 
 	// -Constructors-
 	
+	// Register the Type(Arguments...) constructor, constructors are indexed by their signature
 	template< typename Type, typename... Arguments>
 	void AddConstructor();
 
-	template< typename ConstructionType, typename... Arguments >
-	ConstructionType* Create(Arguments... args);
+	// Create an instance with the constructor matching ConstructionType*(Arguments...), arguments are forwarded to the constructor
+	// @Detail: The signature is deduced from the decayed argument types unless Arguments are given explicitly,
+	// returns null if no constructor matches the signature. The instance is taken from the pool when pooling is enabled
+	template< typename ConstructionType, typename... Arguments, typename... Forwarded >
+	ConstructionType* Create(Forwarded&&... arguments);
+
+	template< typename ConstructionType, typename... Arguments, typename... Forwarded >
+	bool TryCreate(ConstructionType** instance, Forwarded&&... arguments);
 
-	template< typename ConstructionType, typename... Arguments >
-	bool TryCreate(ConstructionType** instance, Arguments... args);
+	// Construct an instance in memory, see Create
+	// @Detail: memory must hold at least GetSize() bytes aligned to GetAlignment(),
+	// the instance must be released with DestroyAt
+	template< typename ConstructionType, typename... Arguments, typename... Forwarded >
+	ConstructionType* CreateAt(void* memory, Forwarded&&... arguments);
 
 	template< typename ClassType, typename... Arguments >
 	bool HasConstructor();
 
+	// Destroy and free an instance returned by Create, pooled instances are returned to the pool
+	inline void Destroy(void* instance);
+
+	// Destroy an instance returned by CreateAt, the memory is left to the caller
+	inline void DestroyAt(void* instance);
+
+	// Retrieve the size and alignment of the type
+	// @Detail: Both are 0 until a constructor has been registered
+	inline size_t GetSize() const;
+	inline size_t GetAlignment() const;
+
+	// -Pooling-
+
+	// Recycle the storage of instances made through Create and Destroy, storage is allocated slotsPerSlab instances at a time
+	// @Detail: A constructor must be registered first. Enable pooling before creating instances,
+	// pooled instances must be destroyed before the TypeInfo
+	inline void EnablePool(size_t slotsPerSlab = 64);
+
+	inline bool IsPooled() const;
+
+	// Retrieve the occupancy of the pool, pooling must be enabled
+	inline PoolStats GetPoolStats() const;
+
+	// -Memory-
+
+	// Add the size of the type info, its constructors, methods, members, lookup tables and pool to stats
+	inline void AddMemoryStats(MemoryStats* stats) const;
+
 	// -MemberInfo-
 
 	template< typename ClassType, typename MemberType >
 	MemberInfo* AddMember(HashID key, MemberInfo::MemberPointer<ClassType, MemberType> member);
 
+	// Register a member and keep its name, names are required by text serialization
+	// @Detail: The name isn't copied and must outlive the TypeInfo, such as a string literal.
+	// Kept apart from AddMember since a const char* overload would silently keep names such as std::string::c_str()
+	template< typename ClassType, typename MemberType >
+	MemberInfo* AddNamedMember(const char* name, MemberInfo::MemberPointer<ClassType, MemberType> member);
+
 	inline MemberInfo* GetMemberInfo(HashID key);
 
 	inline bool HasMember(HashID key);
@@ -55,9 +116,18 @@ public:
 
 	inline MetaData* GetMetaData();
 
+	// Retrieve the identity of the reflected type
+	inline TypeId GetTypeId() const;
+
+	// Compact the method, member and meta data lookups into sorted tables
+	// @Detail: No methods, members or meta data can be added afterwards, constructors can still be added
+	inline void Freeze();
 
-	inline std::unordered_map<uint32_t, MethodInfo>* GetMethods();
-	inline std::unordered_map<uint32_t, MemberInfo>* GetMembers();
+	inline bool IsFrozen() const;
+
+
+	inline std::unordered_map<HashID::ValueType, MethodInfo>* GetMethods();
+	inline std::unordered_map<HashID::ValueType, MemberInfo>* GetMembers();
 
 	// -Structors-
 
@@ -67,11 +137,35 @@ public:
 
 private:
 
+	// Create an instance with the constructor matching the ConstructionType*(Arguments...) signature
+	template< typename ConstructionType, typename... Arguments, typename... Forwarded >
+	ConstructionType* CreateSignature(Detail::TypeList<Arguments...> signature, Forwarded&&... arguments);
+
+	// Construct an instance in memory with the constructor matching the ConstructionType*(Arguments...) signature
+	template< typename ConstructionType, typename... Arguments, typename... Forwarded >
+	ConstructionType* CreateSignatureAt(Detail::TypeList<Arguments...> signature, void* memory, Forwarded&&... arguments);
+
+	template< typename Type >
+	static void DestroyInstance(void* instance);
+
+	template< typename Type >
+	static void DestroyInstanceAt(void* instance);
+
 	Type m_Type;
 
-	std::vector<Delegate> m_Constructors;
-	std::unordered_map<uint32_t, MethodInfo> m_Methods;
-	std::unordered_map<uint32_t, MemberInfo> m_Members;
+	std::unordered_map<TypeId, Detail::ConstructorEntry> m_Constructors;
+	size_t m_Size;
+	size_t m_Alignment;
+	void(*m_Destroy)(void*);
+	void(*m_DestroyAt)(void*);
+
+	std::unique_ptr<ObjectPool> m_Pool;
+
+	std::unordered_map<HashID::ValueType, MethodInfo> m_Methods;
+	std::unordered_map<HashID::ValueType, MemberInfo> m_Members;
+
+	Detail::FrozenTable<MethodInfo> m_FrozenMethods;
+	Detail::FrozenTable<MemberInfo> m_FrozenMembers;
 	
 	MetaData m_MetaData;
 };
@@ -82,39 +176,203 @@ private:
 template< typename Type, typename... Arguments >
 void TypeInfo::AddConstructor() {
 
-	m_Constructors.push_back(Delegate([](Arguments... args)->Type* { return new Type(args...); }));
+	// The constructor must build our type
+	MIST_ASSERT(m_Type.Is<Type>());
+
+	Detail::ConstructorEntry constructor = {
+		Delegate([](Arguments... args)->Type* { return new Type(std::forward<Arguments>(args)...); }),
+		Delegate([](void* memory, Arguments... args)->Type* { return new (memory) Type(std::forward<Arguments>(args)...); })
+	};
+
+	auto result = m_Constructors.emplace(TypeId::Get<Type*(Arguments...)>(), std::move(constructor));
+
+	// The constructor was already registered
+	MIST_ASSERT(result.second);
+	(void)result;
+
+	m_Size = sizeof(Type);
+	m_Alignment = alignof(Type);
+	m_Destroy = &DestroyInstance<Type>;
+	m_DestroyAt = &DestroyInstanceAt<Type>;
+
+	// Members and methods bump the generation as they're attached, see Reflection::GetSchemaGeneration
+	if (Detail::MetaDataIndex* index = m_MetaData.GetIndex()) {
+		index->BumpGeneration();
+	}
+}
+
+template< typename ConstructionType, typename... Arguments, typename... Forwarded >
+ConstructionType* TypeInfo::Create(Forwarded&&... arguments) {
+
+	using Signature = typename Detail::ArgumentList<Detail::TypeList<Arguments...>, Forwarded...>::List;
+	return CreateSignature<ConstructionType>(Signature(), std::forward<Forwarded>(arguments)...);
+}
+
+template< typename ConstructionType, typename... Arguments, typename... Forwarded >
+bool TypeInfo::TryCreate(ConstructionType** instance, Forwarded&&... arguments) {
+
+	*instance = Create<ConstructionType, Arguments...>(std::forward<Forwarded>(arguments)...);
+	return *instance != nullptr;
+}
+
+template< typename ConstructionType, typename... Arguments, typename... Forwarded >
+ConstructionType* TypeInfo::CreateAt(void* memory, Forwarded&&... arguments) {
+
+	using Signature = typename Detail::ArgumentList<Detail::TypeList<Arguments...>, Forwarded...>::List;
+	return CreateSignatureAt<ConstructionType>(Signature(), memory, std::forward<Forwarded>(arguments)...);
 }
 
-template< typename ConstructionType, typename... Arguments >
-ConstructionType* TypeInfo::Create(Arguments... arguments) {
+template< typename ConstructionType, typename... Arguments, typename... Forwarded >
+ConstructionType* TypeInfo::CreateSignature(Detail::TypeList<Arguments...> signature, Forwarded&&... arguments) {
 
 	MIST_ASSERT(m_Constructors.empty() == false);
 	MIST_ASSERT(m_Type.Is<ConstructionType>());
 
-	for (auto& constructor : m_Constructors) {
-		if (constructor.HasSignature<ConstructionType*, Arguments...>()) {
-			return constructor.Invoke<ConstructionType*, Arguments...>(arguments...);
+	auto constructor = m_Constructors.find(TypeId::Get<ConstructionType*(Arguments...)>());
+	if (constructor == m_Constructors.end()) {
+		return nullptr;
+	}
+
+	if (m_Pool != nullptr) {
+		Delegate& createAt = constructor->second.m_CreateAt;
+		void* slot = m_Pool->Allocate();
+
+		// The slot goes back to the pool if the constructor throws
+		try {
+			return createAt.InvokeSignature<ConstructionType*>(Detail::TypeList<void*, Arguments...>(), slot, std::forward<Forwarded>(arguments)...);
+		}
+		catch (...) {
+			m_Pool->Free(slot);
+			throw;
 		}
 	}
-	return nullptr;
+
+	Delegate& create = constructor->second.m_Create;
+	return create.InvokeSignature<ConstructionType*>(signature, std::forward<Forwarded>(arguments)...);
 }
 
-template< typename ConstructionType, typename... Arguments >
-bool TypeInfo::TryCreate(ConstructionType** instance, Arguments... args) {
+template< typename ConstructionType, typename... Arguments, typename... Forwarded >
+ConstructionType* TypeInfo::CreateSignatureAt(Detail::TypeList<Arguments...>, void* memory, Forwarded&&... arguments) {
 
-	*instance = Create<ConstructionType, Arguments...>(args...);
-	return *instance != nullptr;
+	MIST_ASSERT(m_Constructors.empty() == false);
+	MIST_ASSERT(m_Type.Is<ConstructionType>());
+
+	// The memory must be suitably aligned for the type
+	MIST_ASSERT(memory != nullptr && reinterpret_cast<uintptr_t>(memory) % alignof(ConstructionType) == 0);
+
+	auto constructor = m_Constructors.find(TypeId::Get<ConstructionType*(Arguments...)>());
+	if (constructor == m_Constructors.end()) {
+		return nullptr;
+	}
+
+	Delegate& createAt = constructor->second.m_CreateAt;
+	return createAt.InvokeSignature<ConstructionType*>(Detail::TypeList<void*, Arguments...>(), memory, std::forward<Forwarded>(arguments)...);
 }
 
 template< typename ClassType, typename... Arguments >
 bool TypeInfo::HasConstructor() {
 
+	return m_Constructors.find(TypeId::Get<ClassType*(Arguments...)>()) != m_Constructors.end();
+}
+
+inline void TypeInfo::Destroy(void* instance) {
+
+	if (instance == nullptr) {
+		return;
+	}
+
+	// Only instances created through a registered constructor can be destroyed
+	MIST_ASSERT(m_Destroy != nullptr);
+
+	if (m_Pool != nullptr) {
+		m_DestroyAt(instance);
+		m_Pool->Free(instance);
+	}
+	else {
+		m_Destroy(instance);
+	}
+}
+
+inline void TypeInfo::DestroyAt(void* instance) {
+
+	if (instance == nullptr) {
+		return;
+	}
+
+	// Only instances created through a registered constructor can be destroyed
+	MIST_ASSERT(m_DestroyAt != nullptr);
+	m_DestroyAt(instance);
+}
+
+inline size_t TypeInfo::GetSize() const {
+
+	return m_Size;
+}
+
+inline size_t TypeInfo::GetAlignment() const {
+
+	return m_Alignment;
+}
+
+inline void TypeInfo::EnablePool(size_t slotsPerSlab) {
+
+	// The size of the type is only known once a constructor is registered
+	MIST_ASSERT(m_Size != 0);
+
+	if (m_Pool == nullptr) {
+		m_Pool.reset(new ObjectPool(m_Size, m_Alignment, slotsPerSlab));
+	}
+}
+
+inline bool TypeInfo::IsPooled() const {
+
+	return m_Pool != nullptr;
+}
+
+inline PoolStats TypeInfo::GetPoolStats() const {
+
+	MIST_ASSERT(IsPooled());
+	return m_Pool->GetStats();
+}
+
+inline void TypeInfo::AddMemoryStats(MemoryStats* stats) const {
+
+	stats->m_TypeInfoBytes += sizeof(TypeInfo);
+	++stats->m_TypeCount;
+	m_MetaData.AddMemoryStats(stats);
+
+	stats->m_HashTableBytes += Detail::GetHashTableSize(m_Constructors);
 	for (const auto& constructor : m_Constructors) {
-		if (constructor.HasSignature<ClassType*, Arguments...>()) {
-			return true;
-		}
+		stats->m_DelegateBytes += sizeof(Detail::ConstructorEntry) + constructor.second.m_Create.GetHeapSize() + constructor.second.m_CreateAt.GetHeapSize();
+	}
+
+	stats->m_HashTableBytes += Detail::GetHashTableSize(m_Methods) + m_FrozenMethods.GetHeapSize();
+	for (const auto& method : m_Methods) {
+		method.second.AddMemoryStats(stats);
+	}
+
+	stats->m_HashTableBytes += Detail::GetHashTableSize(m_Members) + m_FrozenMembers.GetHeapSize();
+	for (const auto& member : m_Members) {
+		member.second.AddMemoryStats(stats);
+	}
+
+	// The slots are owned by the pool whether they're handed out or not
+	if (m_Pool != nullptr) {
+		const PoolStats pool = m_Pool->GetStats();
+		stats->m_PoolBytes += sizeof(ObjectPool) + pool.m_Capacity * pool.m_SlotSize;
 	}
-	return false;
+}
+
+template< typename Type >
+void TypeInfo::DestroyInstance(void* instance) {
+
+	delete static_cast<Type*>(instance);
+}
+
+template< typename Type >
+void TypeInfo::DestroyInstanceAt(void* instance) {
+
+	static_cast<Type*>(instance)->~Type();
 }
 
 template< typename ClassType, typename MemberType >
@@ -124,21 +382,44 @@ MemberInfo* TypeInfo::AddMember(HashID key, MemberInfo::MemberPointer<ClassType,
 	MIST_ASSERT(m_Type.Is<ClassType>());
 
 	MIST_ASSERT(HasMember(key) == false);
+	MIST_ASSERT(IsFrozen() == false);
 	auto result = m_Members.emplace(key.GetValue(), MemberInfo(member));
 
 	// Assure that the insertion took place
 	MIST_ASSERT(result.second);
-	return &result.first->second;
+	MIST_PROFILE_REGISTRATION_COUNT(m_MemberCount);
+
+	// Members are indexed along with the type holding them
+	MemberInfo* memberInfo = &result.first->second;
+	if (Detail::MetaDataIndex* index = m_MetaData.GetIndex()) {
+		index->Attach(memberInfo->GetMetaData(), { TaggedInfo::Kind::Member, key.GetValue(), memberInfo, this });
+	}
+	return memberInfo;
+}
+
+template< typename ClassType, typename MemberType >
+MemberInfo* TypeInfo::AddNamedMember(const char* name, MemberInfo::MemberPointer<ClassType, MemberType> member) {
+
+	MemberInfo* memberInfo = AddMember(HashID(name), member);
+	memberInfo->m_Name = name;
+	return memberInfo;
 }
 
 inline MemberInfo* TypeInfo::GetMemberInfo(HashID key) {
 
 	MIST_ASSERT(HasMember(key));
+
+	if (IsFrozen()) {
+		return m_FrozenMembers.Find(key.GetValue());
+	}
 	return &m_Members.at(key.GetValue());
 }
 
 inline bool TypeInfo::HasMember(HashID key) {
 
+	if (IsFrozen()) {
+		return m_FrozenMembers.Find(key.GetValue()) != nullptr;
+	}
 	return m_Members.find(key.GetValue()) != m_Members.end();
 }
 
@@ -149,21 +430,36 @@ MethodInfo* TypeInfo::AddMethod(HashID key, MethodInfo::MethodPointer<ClassType,
 	MIST_ASSERT(m_Type.Is<ClassType>());
 
 	MIST_ASSERT(HasMethod(key) == false);
+	MIST_ASSERT(IsFrozen() == false);
 	auto result = m_Methods.emplace(key.GetValue(), MethodInfo(method));
 
 	// Assure that the insertion took place
 	MIST_ASSERT(result.second);
-	return &result.first->second;
+	MIST_PROFILE_REGISTRATION_COUNT(m_MethodCount);
+
+	// Methods are indexed along with the type holding them
+	MethodInfo* methodInfo = &result.first->second;
+	if (Detail::MetaDataIndex* index = m_MetaData.GetIndex()) {
+		index->Attach(methodInfo->GetMetaData(), { TaggedInfo::Kind::Method, key.GetValue(), methodInfo, this });
+	}
+	return methodInfo;
 }
 
 inline MethodInfo* TypeInfo::GetMethodInfo(HashID key) {
 
 	MIST_ASSERT(HasMethod(key));
+
+	if (IsFrozen()) {
+		return m_FrozenMethods.Find(key.GetValue());
+	}
 	return &m_Methods.at(key.GetValue());
 }
 
 inline bool TypeInfo::HasMethod(HashID key) {
 
+	if (IsFrozen()) {
+		return m_FrozenMethods.Find(key.GetValue()) != nullptr;
+	}
 	return m_Methods.find(key.GetValue()) != m_Methods.end();
 }
 
@@ -173,19 +469,44 @@ inline MetaData* TypeInfo::GetMetaData() {
 	return &m_MetaData;
 }
 
-inline std::unordered_map<uint32_t, MethodInfo>* TypeInfo::GetMethods() {
+inline void TypeInfo::Freeze() {
+
+	for (auto& method : m_Methods) {
+		method.second.GetMetaData()->Freeze();
+	}
+	for (auto& member : m_Members) {
+		member.second.GetMetaData()->Freeze();
+	}
+
+	m_FrozenMethods.Build(m_Methods);
+	m_FrozenMembers.Build(m_Members);
+	m_MetaData.Freeze();
+}
+
+inline bool TypeInfo::IsFrozen() const {
+
+	return m_FrozenMethods.IsBuilt();
+}
+
+inline std::unordered_map<HashID::ValueType, MethodInfo>* TypeInfo::GetMethods() {
 
 	return &m_Methods;
 }
 
-inline std::unordered_map<uint32_t, MemberInfo>* TypeInfo::GetMembers() {
+inline TypeId TypeInfo::GetTypeId() const {
+
+	return m_Type.GetId();
+}
+
+inline std::unordered_map<HashID::ValueType, MemberInfo>* TypeInfo::GetMembers() {
 
 	return &m_Members;
 }
 
 // Pass in the defined type because constructors can't have default
 // constructed template constructors
-inline TypeInfo::TypeInfo(Type type) : m_Type(std::move(type)) {}
+inline TypeInfo::TypeInfo(Type type)
+	: m_Type(std::move(type)), m_Size(0), m_Alignment(0), m_Destroy(nullptr), m_DestroyAt(nullptr) {}
 
 
 MIST_NAMESPACE_END
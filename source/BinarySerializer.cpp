@@ -0,0 +1,119 @@
+#include "../include/BinarySerializer.h"
+#include <cstdint>
+#include <string>
+
+MIST_NAMESPACE
+
+namespace {
+
+	// Strings are written as their 64 bit length followed by their characters
+	void WriteString(const std::string& string, std::vector<unsigned char>* output) {
+
+		const uint64_t length = string.size();
+		const unsigned char* lengthBytes = reinterpret_cast<const unsigned char*>(&length);
+		output->insert(output->end(), lengthBytes, lengthBytes + sizeof(length));
+		output->insert(output->end(), string.begin(), string.end());
+	}
+
+	bool ReadString(const unsigned char** cursor, const unsigned char* end, std::string* string) {
+
+		uint64_t length;
+		if (static_cast<size_t>(end - *cursor) < sizeof(length)) {
+			return false;
+		}
+		std::memcpy(&length, *cursor, sizeof(length));
+
+		if (static_cast<uint64_t>(end - *cursor - sizeof(length)) < length) {
+			return false;
+		}
+
+		*cursor += sizeof(length);
+		string->assign(reinterpret_cast<const char*>(*cursor), static_cast<size_t>(length));
+		*cursor += length;
+		return true;
+	}
+}
+
+bool BinarySerializer::Write(TypeId type, const void* object, std::vector<unsigned char>* output) {
+
+	MIST_ASSERT(object != nullptr);
+	MIST_ASSERT(output != nullptr);
+
+	const Detail::Layout* layout = m_Layouts.Get(type);
+	if (layout == nullptr) {
+		return false;
+	}
+
+	WriteLayout(*layout, static_cast<const unsigned char*>(object), output);
+	return true;
+}
+
+bool BinarySerializer::Read(TypeId type, const unsigned char** cursor, const unsigned char* end, void* object) {
+
+	MIST_ASSERT(object != nullptr);
+	MIST_ASSERT(cursor != nullptr && *cursor <= end);
+
+	const Detail::Layout* layout = m_Layouts.Get(type);
+	return layout != nullptr && ReadLayout(*layout, cursor, end, static_cast<unsigned char*>(object));
+}
+
+BinarySerializer::BinarySerializer(Reflection* reflection)
+	: m_Layouts(reflection, Detail::LayoutBuilder::Bytewise::TriviallyCopyable) {
+
+	AddCodec<std::string>(&WriteString, &ReadString);
+}
+
+void BinarySerializer::WriteLayout(const Detail::Layout& layout, const unsigned char* object, std::vector<unsigned char>* output) {
+
+	for (const Detail::LayoutRun& run : layout.m_Runs) {
+
+		const Detail::LayoutField& field = layout.m_Fields[run.m_FirstField];
+		const unsigned char* source = object + field.m_Offset;
+		switch (field.m_Kind) {
+		case Detail::LayoutField::Kind::Bytes:
+			output->insert(output->end(), source, source + run.m_Size);
+			break;
+
+		case Detail::LayoutField::Kind::Custom:
+			static_cast<Detail::SerializationCodec*>(field.m_Custom)->m_Write.Invoke<void, const void*, std::vector<unsigned char>*>(source, output);
+			break;
+
+		case Detail::LayoutField::Kind::Member:
+			WriteLayout(*field.m_Layout, static_cast<const unsigned char*>(field.m_Member->Resolve(static_cast<const void*>(source))), output);
+			break;
+		}
+	}
+}
+
+bool BinarySerializer::ReadLayout(const Detail::Layout& layout, const unsigned char** cursor, const unsigned char* end, unsigned char* object) {
+
+	for (const Detail::LayoutRun& run : layout.m_Runs) {
+
+		const Detail::LayoutField& field = layout.m_Fields[run.m_FirstField];
+		unsigned char* destination = object + field.m_Offset;
+		switch (field.m_Kind) {
+		case Detail::LayoutField::Kind::Bytes:
+			if (static_cast<size_t>(end - *cursor) < run.m_Size) {
+				return false;
+			}
+			std::memcpy(destination, *cursor, run.m_Size);
+			*cursor += run.m_Size;
+			break;
+
+		case Detail::LayoutField::Kind::Custom:
+			if (static_cast<Detail::SerializationCodec*>(field.m_Custom)->m_Read.Invoke<bool, const unsigned char**, const unsigned char*, void*>(cursor, end, destination) == false) {
+				return false;
+			}
+			break;
+
+		case Detail::LayoutField::Kind::Member:
+			if (ReadLayout(*field.m_Layout, cursor, end, static_cast<unsigned char*>(field.m_Member->Resolve(destination))) == false) {
+				return false;
+			}
+			break;
+		}
+	}
+	return true;
+}
+
+MIST_NAMESPACE_END
@@ -0,0 +1,859 @@
+#include "../include/JsonSerializer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+MIST_NAMESPACE
+
+namespace {
+
+	// Output is written to the stream in blocks of this size, input is read in chunks of this size
+	const size_t BLOCK_SIZE = 64 * 1024;
+
+	bool IsWhitespace(char character) {
+
+		return character == ' ' || character == '\t' || character == '\n' || character == '\r';
+	}
+
+	bool IsNumberCharacter(char character) {
+
+		return (character >= '0' && character <= '9') || character == '-' || character == '+' || character == '.' || character == 'e' || character == 'E';
+	}
+
+	bool IsLiteralCharacter(char character) {
+
+		return character >= 'a' && character <= 'z';
+	}
+
+	// Determine the kind of a value that isn't a reflected object
+	bool GetValueKind(TypeId type, Detail::JsonField::Kind* kind) {
+
+		using Kind = Detail::JsonField::Kind;
+		const std::pair<TypeId, Kind> KINDS[] = {
+			{ TypeId::Get<bool>(), Kind::Bool },
+			{ TypeId::Get<char>(), std::numeric_limits<char>::is_signed ? Kind::Signed : Kind::Unsigned },
+			{ TypeId::Get<signed char>(), Kind::Signed },
+			{ TypeId::Get<short>(), Kind::Signed },
+			{ TypeId::Get<int>(), Kind::Signed },
+			{ TypeId::Get<long>(), Kind::Signed },
+			{ TypeId::Get<long long>(), Kind::Signed },
+			{ TypeId::Get<unsigned char>(), Kind::Unsigned },
+			{ TypeId::Get<unsigned short>(), Kind::Unsigned },
+			{ TypeId::Get<unsigned int>(), Kind::Unsigned },
+			{ TypeId::Get<unsigned long>(), Kind::Unsigned },
+			{ TypeId::Get<unsigned long long>(), Kind::Unsigned },
+			{ TypeId::Get<float>(), Kind::Float },
+			{ TypeId::Get<double>(), Kind::Double },
+			{ TypeId::Get<std::string>(), Kind::String }
+		};
+
+		for (const std::pair<TypeId, Kind>& entry : KINDS) {
+			if (entry.first == type) {
+				*kind = entry.second;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	template< typename IntegerType >
+	IntegerType Load(const unsigned char* address) {
+
+		IntegerType value;
+		std::memcpy(&value, address, sizeof(value));
+		return value;
+	}
+
+	template< typename IntegerType >
+	void Store(unsigned char* address, IntegerType value) {
+
+		std::memcpy(address, &value, sizeof(value));
+	}
+
+	int64_t LoadSigned(const unsigned char* address, size_t size) {
+
+		switch (size) {
+		case 1: return Load<int8_t>(address);
+		case 2: return Load<int16_t>(address);
+		case 4: return Load<int32_t>(address);
+		default: return Load<int64_t>(address);
+		}
+	}
+
+	uint64_t LoadUnsigned(const unsigned char* address, size_t size) {
+
+		switch (size) {
+		case 1: return Load<uint8_t>(address);
+		case 2: return Load<uint16_t>(address);
+		case 4: return Load<uint32_t>(address);
+		default: return Load<uint64_t>(address);
+		}
+	}
+
+	// Store a value in an integer of size bytes, false if it doesn't fit
+	bool StoreSigned(unsigned char* address, size_t size, int64_t value) {
+
+		switch (size) {
+		case 1:
+			if (value < INT8_MIN || value > INT8_MAX) {
+				return false;
+			}
+			Store(address, static_cast<int8_t>(value));
+			return true;
+		case 2:
+			if (value < INT16_MIN || value > INT16_MAX) {
+				return false;
+			}
+			Store(address, static_cast<int16_t>(value));
+			return true;
+		case 4:
+			if (value < INT32_MIN || value > INT32_MAX) {
+				return false;
+			}
+			Store(address, static_cast<int32_t>(value));
+			return true;
+		default:
+			Store(address, value);
+			return true;
+		}
+	}
+
+	bool StoreUnsigned(unsigned char* address, size_t size, uint64_t value) {
+
+		switch (size) {
+		case 1:
+			if (value > UINT8_MAX) {
+				return false;
+			}
+			Store(address, static_cast<uint8_t>(value));
+			return true;
+		case 2:
+			if (value > UINT16_MAX) {
+				return false;
+			}
+			Store(address, static_cast<uint16_t>(value));
+			return true;
+		case 4:
+			if (value > UINT32_MAX) {
+				return false;
+			}
+			Store(address, static_cast<uint32_t>(value));
+			return true;
+		default:
+			Store(address, value);
+			return true;
+		}
+	}
+
+	void AppendString(std::string* buffer, const char* string, size_t length) {
+
+		static const char HEX[] = "0123456789abcdef";
+
+		buffer->push_back('"');
+		const char* runBegin = string;
+		for (const char* character = string; character != string + length; ++character) {
+
+			const unsigned char value = static_cast<unsigned char>(*character);
+			if (value >= 0x20 && value != '"' && value != '\\') {
+				continue;
+			}
+
+			// Characters that don't need escaping are appended in runs
+			buffer->append(runBegin, character);
+			runBegin = character + 1;
+
+			buffer->push_back('\\');
+			switch (value) {
+			case '"': buffer->push_back('"'); break;
+			case '\\': buffer->push_back('\\'); break;
+			case '\n': buffer->push_back('n'); break;
+			case '\r': buffer->push_back('r'); break;
+			case '\t': buffer->push_back('t'); break;
+			default:
+				buffer->append("u00");
+				buffer->push_back(HEX[value >> 4]);
+				buffer->push_back(HEX[value & 0xF]);
+				break;
+			}
+		}
+		buffer->append(runBegin, string + length);
+		buffer->push_back('"');
+	}
+
+	void AppendUtf8(std::string* output, uint32_t codePoint) {
+
+		if (codePoint < 0x80) {
+			output->push_back(static_cast<char>(codePoint));
+		}
+		else if (codePoint < 0x800) {
+			output->push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+			output->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+		}
+		else if (codePoint < 0x10000) {
+			output->push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+			output->push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+			output->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+		}
+		else {
+			output->push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+			output->push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+			output->push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+			output->push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+		}
+	}
+
+	bool ParseHex(const char* digits, uint32_t* value) {
+
+		*value = 0;
+		for (size_t i = 0; i < 4; ++i) {
+			const char digit = digits[i];
+			*value <<= 4;
+			if (digit >= '0' && digit <= '9') {
+				*value |= digit - '0';
+			}
+			else if (digit >= 'a' && digit <= 'f') {
+				*value |= digit - 'a' + 10;
+			}
+			else if (digit >= 'A' && digit <= 'F') {
+				*value |= digit - 'A' + 10;
+			}
+			else {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Resolve the escape sequences of the characters of a string token
+	bool Unescape(const std::string& token, std::string* output) {
+
+		output->clear();
+		output->reserve(token.size());
+		for (size_t i = 0; i < token.size(); ++i) {
+
+			if (token[i] != '\\') {
+				output->push_back(token[i]);
+				continue;
+			}
+
+			if (++i == token.size()) {
+				return false;
+			}
+
+			switch (token[i]) {
+			case '"': output->push_back('"'); break;
+			case '\\': output->push_back('\\'); break;
+			case '/': output->push_back('/'); break;
+			case 'b': output->push_back('\b'); break;
+			case 'f': output->push_back('\f'); break;
+			case 'n': output->push_back('\n'); break;
+			case 'r': output->push_back('\r'); break;
+			case 't': output->push_back('\t'); break;
+			case 'u': {
+				uint32_t codePoint;
+				if (i + 4 >= token.size() || ParseHex(&token[i + 1], &codePoint) == false) {
+					return false;
+				}
+				i += 4;
+
+				// Characters outside of the basic plane are escaped as a surrogate pair
+				if (codePoint >= 0xD800 && codePoint < 0xDC00) {
+					uint32_t low;
+					if (i + 6 >= token.size() || token[i + 1] != '\\' || token[i + 2] != 'u' || ParseHex(&token[i + 3], &low) == false
+						|| low < 0xDC00 || low >= 0xE000) {
+						return false;
+					}
+					i += 6;
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+				}
+				AppendUtf8(output, codePoint);
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+// -JsonSerializer-
+
+bool JsonSerializer::Write(TypeId type, const void* object, std::ostream& stream) {
+
+	MIST_ASSERT(object != nullptr);
+
+	const Detail::JsonPlan* plan = GetPlan(type);
+	if (plan == nullptr) {
+		return false;
+	}
+
+	std::string buffer;
+	buffer.reserve(BLOCK_SIZE);
+	WriteObject(*plan, static_cast<const unsigned char*>(object), &buffer, stream);
+	stream.write(buffer.data(), buffer.size());
+	return true;
+}
+
+bool JsonSerializer::Read(TypeId type, std::istream& stream, void* object) {
+
+	JsonReader reader(this);
+	reader.Begin(type, object);
+
+	std::vector<char> chunk(BLOCK_SIZE);
+	while (stream) {
+		stream.read(chunk.data(), chunk.size());
+		if (reader.Feed(chunk.data(), static_cast<size_t>(stream.gcount())) == false) {
+			return false;
+		}
+	}
+	return reader.Finish();
+}
+
+JsonSerializer::JsonSerializer(Reflection* reflection)
+	: m_TypeIndex(reflection) {
+}
+
+const Detail::JsonPlan* JsonSerializer::GetPlan(TypeId type) {
+
+	auto found = m_Plans.find(type);
+	if (found != m_Plans.end()) {
+		return found->second.get();
+	}
+
+	// The type isn't reflected
+	TypeInfo* typeInfo = m_TypeIndex.Find(type);
+	MIST_ASSERT(typeInfo != nullptr);
+	if (typeInfo == nullptr) {
+		return nullptr;
+	}
+
+	std::unique_ptr<Detail::JsonPlan> plan(new Detail::JsonPlan());
+	for (auto& member : *typeInfo->GetMembers()) {
+
+		// Text serialization requires the member to be registered with its name, members registered with a HashID are skipped
+		MemberInfo* memberInfo = &member.second;
+		if (memberInfo->GetName() == nullptr) {
+			continue;
+		}
+
+		Detail::JsonField field = { memberInfo->GetName(), member.first, Detail::JsonField::Kind::Object, memberInfo->GetSize(), memberInfo, nullptr };
+		if (GetValueKind(memberInfo->GetTypeId(), &field.m_Kind) == false) {
+			field.m_Plan = GetPlan(memberInfo->GetTypeId());
+			if (field.m_Plan == nullptr) {
+				return nullptr;
+			}
+		}
+		plan->m_Fields.push_back(field);
+	}
+
+	// Fields are written in offset order, fields without offsets follow in name order
+	std::sort(plan->m_Fields.begin(), plan->m_Fields.end(), [](const Detail::JsonField& left, const Detail::JsonField& right) {
+		if (left.m_Member->HasOffset() != right.m_Member->HasOffset()) {
+			return left.m_Member->HasOffset();
+		}
+		if (left.m_Member->HasOffset() && left.m_Member->GetOffset() != right.m_Member->GetOffset()) {
+			return left.m_Member->GetOffset() < right.m_Member->GetOffset();
+		}
+		return std::strcmp(left.m_Name, right.m_Name) < 0;
+	});
+
+	for (const Detail::JsonField& field : plan->m_Fields) {
+		plan->m_KeyFields.push_back(&field);
+	}
+	std::sort(plan->m_KeyFields.begin(), plan->m_KeyFields.end(), [](const Detail::JsonField* left, const Detail::JsonField* right) {
+		return left->m_Key < right->m_Key;
+	});
+	for (const Detail::JsonField* field : plan->m_KeyFields) {
+		plan->m_Keys.push_back(field->m_Key);
+	}
+
+	const Detail::JsonPlan* result = plan.get();
+	m_Plans.emplace(type, std::move(plan));
+	return result;
+}
+
+void JsonSerializer::WriteObject(const Detail::JsonPlan& plan, const unsigned char* object, std::string* buffer, std::ostream& stream) {
+
+	buffer->push_back('{');
+	for (size_t i = 0; i < plan.m_Fields.size(); ++i) {
+
+		const Detail::JsonField& field = plan.m_Fields[i];
+		const unsigned char* address = static_cast<const unsigned char*>(field.m_Member->Resolve(static_cast<const void*>(object)));
+
+		if (i > 0) {
+			buffer->push_back(',');
+		}
+		AppendString(buffer, field.m_Name, std::strlen(field.m_Name));
+		buffer->push_back(':');
+
+		char number[32];
+		switch (field.m_Kind) {
+		case Detail::JsonField::Kind::Bool:
+			buffer->append(*reinterpret_cast<const bool*>(address) ? "true" : "false");
+			break;
+
+		case Detail::JsonField::Kind::Signed:
+			std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(LoadSigned(address, field.m_Size)));
+			buffer->append(number);
+			break;
+
+		case Detail::JsonField::Kind::Unsigned:
+			std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(LoadUnsigned(address, field.m_Size)));
+			buffer->append(number);
+			break;
+
+		// Enough digits to read back the same value, JSON has no representation for infinities and NaN
+		case Detail::JsonField::Kind::Float: {
+			const float value = Load<float>(address);
+			if (std::isfinite(value)) {
+				std::snprintf(number, sizeof(number), "%.9g", value);
+				buffer->append(number);
+			}
+			else {
+				buffer->append("null");
+			}
+			break;
+		}
+
+		case Detail::JsonField::Kind::Double: {
+			const double value = Load<double>(address);
+			if (std::isfinite(value)) {
+				std::snprintf(number, sizeof(number), "%.17g", value);
+				buffer->append(number);
+			}
+			else {
+				buffer->append("null");
+			}
+			break;
+		}
+
+		case Detail::JsonField::Kind::String: {
+			const std::string& string = *reinterpret_cast<const std::string*>(address);
+			AppendString(buffer, string.data(), string.size());
+			break;
+		}
+
+		case Detail::JsonField::Kind::Object:
+			WriteObject(*field.m_Plan, address, buffer, stream);
+			break;
+		}
+
+		if (buffer->size() >= BLOCK_SIZE) {
+			stream.write(buffer->data(), buffer->size());
+			buffer->clear();
+		}
+	}
+	buffer->push_back('}');
+}
+
+// -JsonReader-
+
+void JsonReader::Begin(TypeId type, void* object) {
+
+	Reset(type, object, false);
+}
+
+void JsonReader::BeginArray(TypeId type, void* element, Delegate onElement) {
+
+	Reset(type, element, true);
+	m_OnElement = std::move(onElement);
+}
+
+bool JsonReader::Feed(const char* data, size_t size) {
+
+	MIST_ASSERT(data != nullptr || size == 0);
+
+	if (m_State == State::Error) {
+		return false;
+	}
+
+	const char* end = data + size;
+	const char* cursor = data;
+	while (cursor != end) {
+
+		if (m_State == State::String) {
+
+			// Scan for the closing quote, escaped characters are resolved once the token is complete
+			const char* begin = cursor;
+			for (; cursor != end; ++cursor) {
+				if (m_IsEscaping) {
+					m_IsEscaping = false;
+				}
+				else if (*cursor == '\\') {
+					m_IsEscaping = true;
+					m_HasEscapes = true;
+				}
+				else if (*cursor == '"') {
+					break;
+				}
+			}
+			m_Token.append(begin, cursor);
+
+			// The string continues in the next chunk
+			if (cursor == end) {
+				break;
+			}
+
+			++cursor;
+			if (CompleteString() == false) {
+				m_Position += cursor - data;
+				m_State = State::Error;
+				return false;
+			}
+			continue;
+		}
+
+		if (m_State == State::Number || m_State == State::Literal) {
+
+			const bool isNumber = m_State == State::Number;
+			const char* begin = cursor;
+			while (cursor != end && (isNumber ? IsNumberCharacter(*cursor) : IsLiteralCharacter(*cursor))) {
+				++cursor;
+			}
+			m_Token.append(begin, cursor);
+
+			// The token continues in the next chunk
+			if (cursor == end) {
+				break;
+			}
+
+			// The character ending the token is processed as a structural character
+			if ((isNumber ? CompleteNumber() : CompleteLiteral()) == false) {
+				m_Position += cursor - data;
+				m_State = State::Error;
+				return false;
+			}
+			continue;
+		}
+
+		const char character = *cursor++;
+		if (IsWhitespace(character)) {
+			continue;
+		}
+
+		if (ProcessCharacter(character) == false) {
+			m_Position += cursor - data - 1;
+			m_State = State::Error;
+			return false;
+		}
+	}
+
+	m_Position += size;
+	return true;
+}
+
+bool JsonReader::Finish() {
+
+	return m_State == State::Done;
+}
+
+bool JsonReader::HasError() const {
+
+	return m_State == State::Error;
+}
+
+size_t JsonReader::GetPosition() const {
+
+	return m_Position;
+}
+
+JsonReader::JsonReader(JsonSerializer* serializer)
+	: m_Serializer(serializer)
+	, m_State(State::Error)
+	, m_Position(0)
+	, m_Target(Target::Root)
+	, m_Field(nullptr)
+	, m_FieldAddress(nullptr)
+	, m_RootPlan(nullptr)
+	, m_RootObject(nullptr)
+	, m_IsArray(false)
+	, m_OnElement([]() {})
+	, m_IsKey(false)
+	, m_IsEscaping(false)
+	, m_HasEscapes(false) {
+
+	MIST_ASSERT(serializer != nullptr);
+}
+
+void JsonReader::Reset(TypeId type, void* object, bool isArray) {
+
+	MIST_ASSERT(object != nullptr);
+
+	m_State = State::Value;
+	m_Position = 0;
+	m_Frames.clear();
+	m_Target = Target::Root;
+	m_Field = nullptr;
+	m_FieldAddress = nullptr;
+	m_RootPlan = m_Serializer->GetPlan(type);
+	m_RootObject = static_cast<unsigned char*>(object);
+	m_IsArray = isArray;
+	m_Token.clear();
+	m_IsKey = false;
+	m_IsEscaping = false;
+	m_HasEscapes = false;
+
+	// Types that can't be read fail on the first chunk
+	if (m_RootPlan == nullptr) {
+		m_State = State::Error;
+	}
+}
+
+bool JsonReader::ProcessCharacter(char character) {
+
+	switch (m_State) {
+	case State::ValueOrEnd:
+		if (character == ']') {
+			PopFrame();
+			return true;
+		}
+		return BeginValue(character);
+
+	case State::Value:
+		return BeginValue(character);
+
+	case State::KeyOrEnd:
+		if (character == '}') {
+			PopFrame();
+			return true;
+		}
+		// Fallthrough
+	case State::Key:
+		if (character != '"') {
+			return false;
+		}
+		m_Token.clear();
+		m_IsKey = true;
+		m_HasEscapes = false;
+		m_State = State::String;
+		return true;
+
+	case State::Colon:
+		if (character != ':') {
+			return false;
+		}
+		m_State = State::Value;
+		return true;
+
+	case State::CommaOrEnd: {
+		const Frame& frame = m_Frames.back();
+		if (character == ',') {
+			if (frame.m_IsArray) {
+				m_Target = frame.m_IsRootArray ? Target::Element : Target::Skip;
+				m_State = State::Value;
+			}
+			else {
+				m_State = State::Key;
+			}
+			return true;
+		}
+
+		if (character == (frame.m_IsArray ? ']' : '}')) {
+			PopFrame();
+			return true;
+		}
+		return false;
+	}
+
+	default:
+		return false;
+	}
+}
+
+bool JsonReader::BeginValue(char character) {
+
+	using Kind = Detail::JsonField::Kind;
+
+	if (character == '{') {
+		switch (m_Target) {
+		case Target::Root:
+			return m_IsArray == false && PushFrame(m_RootPlan, m_RootObject, false, false, false);
+		case Target::Element:
+			return PushFrame(m_RootPlan, m_RootObject, false, false, true);
+		case Target::Field:
+			return m_Field->m_Kind == Kind::Object && PushFrame(m_Field->m_Plan, m_FieldAddress, false, false, false);
+		case Target::Skip:
+			return PushFrame(nullptr, nullptr, false, false, false);
+		}
+	}
+
+	if (character == '[') {
+		if (m_Target == Target::Root) {
+			return m_IsArray && PushFrame(m_RootPlan, m_RootObject, true, true, false);
+		}
+		return m_Target == Target::Skip && PushFrame(nullptr, nullptr, true, false, false);
+	}
+
+	// Only objects can be read into the root and the elements of the top level array
+	if (m_Target == Target::Root || m_Target == Target::Element) {
+		return false;
+	}
+
+	m_Token.clear();
+	if (character == '"') {
+		m_IsKey = false;
+		m_HasEscapes = false;
+		m_State = State::String;
+		return m_Target == Target::Skip || m_Field->m_Kind == Kind::String;
+	}
+
+	if (character == '-' || (character >= '0' && character <= '9')) {
+		m_Token.push_back(character);
+		m_State = State::Number;
+		return m_Target == Target::Skip || (m_Field->m_Kind != Kind::String && m_Field->m_Kind != Kind::Object && m_Field->m_Kind != Kind::Bool);
+	}
+
+	if (IsLiteralCharacter(character)) {
+		m_Token.push_back(character);
+		m_State = State::Literal;
+		return true;
+	}
+	return false;
+}
+
+bool JsonReader::PushFrame(const Detail::JsonPlan* plan, unsigned char* object, bool isArray, bool isRootArray, bool isElement) {
+
+	m_Frames.push_back({ plan, object, isArray, isRootArray, isElement });
+	if (isArray) {
+		m_Target = isRootArray ? Target::Element : Target::Skip;
+		m_State = State::ValueOrEnd;
+	}
+	else {
+		m_State = State::KeyOrEnd;
+	}
+	return true;
+}
+
+void JsonReader::PopFrame() {
+
+	const bool isElement = m_Frames.back().m_IsElement;
+	m_Frames.pop_back();
+
+	if (isElement) {
+		m_OnElement.Invoke<void>();
+	}
+	CompleteValue();
+}
+
+void JsonReader::CompleteValue() {
+
+	m_State = m_Frames.empty() ? State::Done : State::CommaOrEnd;
+}
+
+bool JsonReader::CompleteString() {
+
+	if (m_IsKey) {
+
+		const Frame& frame = m_Frames.back();
+		m_Target = Target::Skip;
+		m_State = State::Colon;
+		if (frame.m_Plan == nullptr) {
+			return true;
+		}
+
+		HashID key(m_Token.data(), m_Token.size());
+		if (m_HasEscapes) {
+			std::string unescaped;
+			if (Unescape(m_Token, &unescaped) == false) {
+				return false;
+			}
+			key = HashID(unescaped.data(), unescaped.size());
+		}
+
+		// Unknown keys are skipped
+		const std::vector<HashID::ValueType>& keys = frame.m_Plan->m_Keys;
+		auto found = std::lower_bound(keys.begin(), keys.end(), key.GetValue());
+		if (found != keys.end() && *found == key.GetValue()) {
+			m_Field = frame.m_Plan->m_KeyFields[found - keys.begin()];
+			m_FieldAddress = static_cast<unsigned char*>(m_Field->m_Member->Resolve(frame.m_Object));
+			m_Target = Target::Field;
+		}
+		return true;
+	}
+
+	CompleteValue();
+	if (m_Target == Target::Skip) {
+		return true;
+	}
+
+	std::string* string = reinterpret_cast<std::string*>(m_FieldAddress);
+	if (m_HasEscapes) {
+		return Unescape(m_Token, string);
+	}
+	string->assign(m_Token);
+	return true;
+}
+
+bool JsonReader::CompleteNumber() {
+
+	CompleteValue();
+	if (m_Target == Target::Skip) {
+		return true;
+	}
+
+	const char* begin = m_Token.c_str();
+	char* end = nullptr;
+	errno = 0;
+
+	bool isStored = false;
+	switch (m_Field->m_Kind) {
+	case Detail::JsonField::Kind::Signed: {
+		const long long value = std::strtoll(begin, &end, 10);
+		isStored = errno == 0 && StoreSigned(m_FieldAddress, m_Field->m_Size, value);
+		break;
+	}
+	case Detail::JsonField::Kind::Unsigned: {
+		// strtoull accepts negative values
+		const unsigned long long value = std::strtoull(begin, &end, 10);
+		isStored = errno == 0 && m_Token[0] != '-' && StoreUnsigned(m_FieldAddress, m_Field->m_Size, value);
+		break;
+	}
+	case Detail::JsonField::Kind::Float: {
+		const float value = std::strtof(begin, &end);
+		Store(m_FieldAddress, value);
+		isStored = true;
+		break;
+	}
+	case Detail::JsonField::Kind::Double: {
+		const double value = std::strtod(begin, &end);
+		Store(m_FieldAddress, value);
+		isStored = true;
+		break;
+	}
+	default:
+		break;
+	}
+
+	// The whole token must be a number
+	return isStored && end == begin + m_Token.size();
+}
+
+bool JsonReader::CompleteLiteral() {
+
+	CompleteValue();
+
+	const bool isTrue = m_Token == "true";
+	if (isTrue == false && m_Token != "false") {
+		return m_Token == "null";
+	}
+
+	if (m_Target == Target::Skip) {
+		return true;
+	}
+
+	if (m_Field->m_Kind != Detail::JsonField::Kind::Bool) {
+		return false;
+	}
+	*reinterpret_cast<bool*>(m_FieldAddress) = isTrue;
+	return true;
+}
+
+MIST_NAMESPACE_END
@@ -0,0 +1,144 @@
+#include "../include/LayoutBuilder.h"
+#include <algorithm>
+
+MIST_NAMESPACE
+
+namespace Detail {
+
+	LayoutBuilder::LayoutBuilder(Reflection* reflection, Bytewise bytewise)
+		: m_TypeIndex(reflection)
+		, m_Bytewise(bytewise)
+		, m_LastLayout(nullptr) {}
+
+	const Layout* LayoutBuilder::Get(TypeId type) {
+
+		if (m_LastLayout != nullptr && m_LastType == type) {
+			return m_LastLayout;
+		}
+
+		auto found = m_Layouts.find(type);
+		if (found != m_Layouts.end()) {
+			m_LastType = type;
+			m_LastLayout = found->second.get();
+			return m_LastLayout;
+		}
+
+		std::unique_ptr<Layout> layout(new Layout());
+
+		auto custom = m_Customs.find(type);
+		if (custom != m_Customs.end()) {
+			layout->m_Fields.push_back({ LayoutField::Kind::Custom, 0, 0, type, custom->second, nullptr, nullptr });
+		}
+		else {
+
+			// The type is neither reflected nor custom
+			TypeInfo* typeInfo = m_TypeIndex.Find(type);
+			MIST_ASSERT(typeInfo != nullptr);
+			if (typeInfo == nullptr) {
+				return nullptr;
+			}
+
+			// Members without offsets follow in name order to keep the order stable
+			std::vector<std::pair<HashID::ValueType, MemberInfo*>> members;
+			for (auto& member : *typeInfo->GetMembers()) {
+				members.emplace_back(member.first, &member.second);
+			}
+			std::sort(members.begin(), members.end(), [](const std::pair<HashID::ValueType, MemberInfo*>& left, const std::pair<HashID::ValueType, MemberInfo*>& right) {
+				if (left.second->HasOffset() != right.second->HasOffset()) {
+					return left.second->HasOffset();
+				}
+				if (left.second->HasOffset() && left.second->GetOffset() != right.second->GetOffset()) {
+					return left.second->GetOffset() < right.second->GetOffset();
+				}
+				return left.first < right.first;
+			});
+
+			for (auto& member : members) {
+				if (AddMemberFields(member.second, 0, &layout->m_Fields) == false) {
+					return nullptr;
+				}
+			}
+		}
+
+		// Group adjacent bytes fields into runs, padding between fields breaks a run
+		for (uint32_t i = 0; i < layout->m_Fields.size(); ++i) {
+
+			const LayoutField& field = layout->m_Fields[i];
+			if (field.m_Kind == LayoutField::Kind::Bytes && layout->m_Runs.empty() == false) {
+				LayoutRun& previous = layout->m_Runs.back();
+				if (previous.m_Size > 0 && previous.m_Offset + previous.m_Size == field.m_Offset) {
+					previous.m_Size += field.m_Size;
+					++previous.m_FieldCount;
+					continue;
+				}
+			}
+
+			const size_t runSize = field.m_Kind == LayoutField::Kind::Bytes ? field.m_Size : 0;
+			layout->m_Runs.push_back({ field.m_Offset, runSize, i, 1 });
+		}
+
+		const Layout* result = layout.get();
+		m_Layouts.emplace(type, std::move(layout));
+		return result;
+	}
+
+	void LayoutBuilder::AddCustom(TypeId type, void* functions) {
+
+		MIST_ASSERT(functions != nullptr);
+
+		// Layouts already built keep the previous behaviour of the type
+		MIST_ASSERT(IsBuilt(type) == false);
+
+		m_Customs[type] = functions;
+	}
+
+	const Layout* LayoutBuilder::GetMemberLayout(const MemberInfo& member) {
+
+		const TypeId type = member.GetTypeId();
+		if (m_Customs.find(type) != m_Customs.end() || m_TypeIndex.Find(type) != nullptr) {
+			return Get(type);
+		}
+
+		auto found = m_Layouts.find(type);
+		if (found != m_Layouts.end()) {
+			return found->second.get();
+		}
+
+		// Members that aren't reflected and aren't custom are handled bytewise, padding would take part in comparisons
+		MIST_ASSERT(IsBytewise(member));
+		if (IsBytewise(member) == false) {
+			return nullptr;
+		}
+
+		std::unique_ptr<Layout> layout(new Layout());
+		layout->m_Fields.push_back({ LayoutField::Kind::Bytes, 0, member.GetSize(), type, nullptr, nullptr, nullptr });
+		layout->m_Runs.push_back({ 0, member.GetSize(), 0, 1 });
+
+		const Layout* result = layout.get();
+		m_Layouts.emplace(type, std::move(layout));
+		return result;
+	}
+
+	bool LayoutBuilder::AddMemberFields(MemberInfo* member, size_t offset, std::vector<LayoutField>* fields) {
+
+		const Layout* layout = GetMemberLayout(*member);
+		if (layout == nullptr) {
+			return false;
+		}
+
+		// Members without a byte offset are resolved through their member pointer for every object
+		if (member->HasOffset() == false) {
+			fields->push_back({ LayoutField::Kind::Member, offset, 0, member->GetTypeId(), nullptr, member, layout });
+			return true;
+		}
+
+		// The fields of the member's type are flattened into ours
+		for (LayoutField field : layout->m_Fields) {
+			field.m_Offset += offset + member->GetOffset();
+			fields->push_back(field);
+		}
+		return true;
+	}
+}
+
+MIST_NAMESPACE_END
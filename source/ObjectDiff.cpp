@@ -0,0 +1,175 @@
+#include "../include/ObjectDiff.h"
+#include <cstring>
+#include <string>
+
+MIST_NAMESPACE
+
+namespace {
+
+	// Field indices are written as variable length integers offset by one, zero ends a patch
+	void WriteIndex(uint32_t value, std::vector<unsigned char>* output) {
+
+		while (value >= 0x80) {
+			output->push_back(static_cast<unsigned char>(value | 0x80));
+			value >>= 7;
+		}
+		output->push_back(static_cast<unsigned char>(value));
+	}
+
+	bool ReadIndex(const unsigned char** cursor, const unsigned char* end, uint32_t* value) {
+
+		uint32_t result = 0;
+		for (uint32_t shift = 0; shift < 35; shift += 7) {
+			if (*cursor == end) {
+				return false;
+			}
+
+			const unsigned char byte = *(*cursor)++;
+			result |= static_cast<uint32_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				*value = result;
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+bool ObjectDiff::Diff(TypeId type, const void* before, const void* after, std::vector<unsigned char>* output) {
+
+	MIST_ASSERT(before != nullptr && after != nullptr);
+	MIST_ASSERT(output != nullptr);
+
+	const Detail::Layout* layout = m_Layouts.Get(type);
+	if (layout == nullptr) {
+		return false;
+	}
+
+	const bool isChanged = DiffObject(*layout, static_cast<const unsigned char*>(before), static_cast<const unsigned char*>(after), output);
+	WriteIndex(0, output);
+	return isChanged;
+}
+
+bool ObjectDiff::Apply(TypeId type, const unsigned char** cursor, const unsigned char* end, void* object) {
+
+	MIST_ASSERT(object != nullptr);
+	MIST_ASSERT(cursor != nullptr && *cursor <= end);
+
+	const Detail::Layout* layout = m_Layouts.Get(type);
+	return layout != nullptr && ApplyObject(*layout, cursor, end, static_cast<unsigned char*>(object));
+}
+
+ObjectDiff::ObjectDiff(Reflection* reflection)
+	: m_Layouts(reflection)
+	, m_Serializer(reflection) {
+
+	// The serializer already has a codec for strings
+	std::unique_ptr<Delegate>& comparer = m_Comparers[TypeId::Get<std::string>()];
+	comparer.reset(new Delegate([](const void* left, const void* right) {
+		return *static_cast<const std::string*>(left) == *static_cast<const std::string*>(right);
+	}));
+	m_Layouts.AddCustom(TypeId::Get<std::string>(), comparer.get());
+}
+
+bool ObjectDiff::DiffObject(const Detail::Layout& layout, const unsigned char* before, const unsigned char* after, std::vector<unsigned char>* output) {
+
+	bool isChanged = false;
+	for (const Detail::LayoutRun& run : layout.m_Runs) {
+
+		// Unchanged runs are skipped without looking at their fields
+		if (run.m_Size > 0 && std::memcmp(before + run.m_Offset, after + run.m_Offset, run.m_Size) == 0) {
+			continue;
+		}
+
+		for (uint32_t i = run.m_FirstField; i < run.m_FirstField + run.m_FieldCount; ++i) {
+			isChanged |= DiffValue(layout.m_Fields[i], i, before, after, output);
+		}
+	}
+	return isChanged;
+}
+
+bool ObjectDiff::DiffValue(const Detail::LayoutField& field, uint32_t index, const unsigned char* before, const unsigned char* after, std::vector<unsigned char>* output) {
+
+	const unsigned char* beforeValue = before + field.m_Offset;
+	const unsigned char* afterValue = after + field.m_Offset;
+	switch (field.m_Kind) {
+	case Detail::LayoutField::Kind::Bytes:
+		if (std::memcmp(beforeValue, afterValue, field.m_Size) == 0) {
+			return false;
+		}
+		WriteIndex(index + 1, output);
+		output->insert(output->end(), afterValue, afterValue + field.m_Size);
+		return true;
+
+	case Detail::LayoutField::Kind::Custom:
+		if (static_cast<Delegate*>(field.m_Custom)->Invoke<bool, const void*, const void*>(beforeValue, afterValue)) {
+			return false;
+		}
+		WriteIndex(index + 1, output);
+		m_Serializer.Write(field.m_Type, afterValue, output);
+		return true;
+
+	case Detail::LayoutField::Kind::Member: {
+
+		// The nested patch is dropped if the member didn't change
+		const size_t mark = output->size();
+		WriteIndex(index + 1, output);
+
+		const unsigned char* beforeMember = static_cast<const unsigned char*>(field.m_Member->Resolve(static_cast<const void*>(beforeValue)));
+		const unsigned char* afterMember = static_cast<const unsigned char*>(field.m_Member->Resolve(static_cast<const void*>(afterValue)));
+		if (DiffObject(*field.m_Layout, beforeMember, afterMember, output)) {
+			WriteIndex(0, output);
+			return true;
+		}
+
+		output->resize(mark);
+		return false;
+	}
+	}
+	return false;
+}
+
+bool ObjectDiff::ApplyObject(const Detail::Layout& layout, const unsigned char** cursor, const unsigned char* end, unsigned char* object) {
+
+	while (true) {
+
+		uint32_t index;
+		if (ReadIndex(cursor, end, &index) == false) {
+			return false;
+		}
+
+		if (index == 0) {
+			return true;
+		}
+
+		if (index > layout.m_Fields.size()) {
+			return false;
+		}
+
+		const Detail::LayoutField& field = layout.m_Fields[index - 1];
+		unsigned char* destination = object + field.m_Offset;
+		switch (field.m_Kind) {
+		case Detail::LayoutField::Kind::Bytes:
+			if (static_cast<size_t>(end - *cursor) < field.m_Size) {
+				return false;
+			}
+			std::memcpy(destination, *cursor, field.m_Size);
+			*cursor += field.m_Size;
+			break;
+
+		case Detail::LayoutField::Kind::Custom:
+			if (m_Serializer.Read(field.m_Type, cursor, end, destination) == false) {
+				return false;
+			}
+			break;
+
+		case Detail::LayoutField::Kind::Member:
+			if (ApplyObject(*field.m_Layout, cursor, end, static_cast<unsigned char*>(field.m_Member->Resolve(destination))) == false) {
+				return false;
+			}
+			break;
+		}
+	}
+}
+
+MIST_NAMESPACE_END
@@ -1,48 +1,412 @@
 #include "../include/Reflection.h"
+#include "../include/Parallel.h"
 #include <Mist_Common/include/UtilityMacros.h>
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <thread>
+#include <vector>
 
 MIST_NAMESPACE
 
+void Reflection::Publish() {
+
+	std::lock_guard<std::recursive_mutex> lock(m_WriteLock);
+
+	// Freeze the entries that haven't been published yet, published entries are left untouched
+	// since readers may be accessing them
+	for (auto& type : m_Types) {
+		FreezeEntry(&type.second);
+	}
+	for (auto& globalFunction : m_GlobalFunctions) {
+		FreezeEntry(&globalFunction.second);
+	}
+	for (auto& globalObject : m_GlobalObjects) {
+		FreezeEntry(&globalObject.second);
+	}
+
+	std::unique_ptr<Detail::ReflectionSnapshot> snapshot(new Detail::ReflectionSnapshot());
+	snapshot->m_Types.Build(m_Types);
+	snapshot->m_GlobalFunctions.Build(m_GlobalFunctions);
+	snapshot->m_GlobalObjects.Build(m_GlobalObjects);
+
+	m_Snapshot.store(snapshot.get(), std::memory_order_release);
+	m_Snapshots.push_back(std::move(snapshot));
+	m_MaterializedCount.store(0, std::memory_order_release);
+}
+
+void Reflection::ReclaimSnapshots() {
+
+	std::lock_guard<std::recursive_mutex> lock(m_WriteLock);
+
+	if (m_Snapshots.size() <= 1) {
+		return;
+	}
+
+	std::vector<std::unique_ptr<Detail::ReflectionSnapshot>> latest;
+	latest.push_back(std::move(m_Snapshots.back()));
+	m_Snapshots.swap(latest);
+}
+
+bool Reflection::Materialize(HashID name) {
+
+	if (m_DeferredCount.load(std::memory_order_acquire) == 0) {
+		return false;
+	}
+
+	std::lock_guard<std::recursive_mutex> lock(m_WriteLock);
+
+	// Another thread may have run the registration while we waited for the lock
+	auto deferred = m_Deferred.find(name.GetValue());
+	if (deferred == m_Deferred.end()) {
+		return false;
+	}
+
+	// The registration may defer other registrations, take it out of the map before running it
+	Delegate registration = std::move(deferred->second);
+	m_Deferred.erase(deferred);
+
+	{
+		MIST_PROFILE_REGISTRATION_SCOPE("Deferred registration");
+		registration.Invoke<void, Reflection*>(this);
+	}
+
+	// Republishing rebuilds every table, wait until the materialized registrations make up half of the snapshot
+	// so that materializing every deferred type one at a time doesn't build a snapshot per type
+	const Detail::ReflectionSnapshot* snapshot = m_Snapshot.load(std::memory_order_acquire);
+	if (snapshot != nullptr) {
+		const size_t published = snapshot->m_Types.Size() + snapshot->m_GlobalFunctions.Size() + snapshot->m_GlobalObjects.Size();
+		if ((m_MaterializedCount.fetch_add(1, std::memory_order_acq_rel) + 1) * 2 > published) {
+			Publish();
+		}
+	}
+
+	// Only count the registration as done once its entries are visible to lookups
+	--m_DeferredCount;
+	return true;
+}
+
+void Reflection::MaterializeAll() {
+
+	std::lock_guard<std::recursive_mutex> lock(m_WriteLock);
+
+	size_t materialized = 0;
+	while (m_Deferred.empty() == false) {
+
+		Delegate registration = std::move(m_Deferred.begin()->second);
+		m_Deferred.erase(m_Deferred.begin());
+
+		MIST_PROFILE_REGISTRATION_SCOPE("Deferred registration");
+		registration.Invoke<void, Reflection*>(this);
+		++materialized;
+	}
+
+	if (materialized > 0 && IsPublished()) {
+		Publish();
+	}
+	m_DeferredCount -= materialized;
+}
+
+void Reflection::Freeze() {
+
+	MaterializeAll();
+	Publish();
+	m_IsFrozen = true;
+}
+
+MemoryStats Reflection::GetMemoryStats() {
+
+	std::lock_guard<std::recursive_mutex> lock(m_WriteLock);
+
+	MemoryStats stats;
+	stats.m_HashTableBytes += Detail::GetHashTableSize(m_Types) + Detail::GetHashTableSize(m_GlobalFunctions) + Detail::GetHashTableSize(m_GlobalObjects);
+	for (const auto& type : m_Types) {
+		type.second.AddMemoryStats(&stats);
+	}
+	for (const auto& globalFunction : m_GlobalFunctions) {
+		globalFunction.second.AddMemoryStats(&stats);
+	}
+	for (const auto& globalObject : m_GlobalObjects) {
+		globalObject.second.AddMemoryStats(&stats);
+	}
+
+	// Pending registrations hold their callable until they run
+	stats.m_HashTableBytes += Detail::GetHashTableSize(m_Deferred);
+	for (const auto& deferred : m_Deferred) {
+		stats.m_DelegateBytes += sizeof(Delegate) + deferred.second.GetHeapSize();
+	}
+
+	// Every snapshot published since the last ReclaimSnapshots is still held
+	stats.m_HashTableBytes += m_Snapshots.capacity() * sizeof(std::unique_ptr<Detail::ReflectionSnapshot>);
+	for (const auto& snapshot : m_Snapshots) {
+		stats.m_HashTableBytes += sizeof(Detail::ReflectionSnapshot) + snapshot->m_Types.GetHeapSize()
+			+ snapshot->m_GlobalFunctions.GetHeapSize() + snapshot->m_GlobalObjects.GetHeapSize();
+	}
+
+	stats.m_HashTableBytes += m_MetaDataIndex.GetHeapSize();
+	return stats;
+}
+
+std::vector<TypeMemoryStats> Reflection::GetTypeMemoryStats() {
+
+	std::lock_guard<std::recursive_mutex> lock(m_WriteLock);
+
+	std::vector<TypeMemoryStats> types;
+	types.reserve(m_Types.size());
+	for (auto& type : m_Types) {
+
+		TypeMemoryStats entry = { type.first, &type.second, MemoryStats() };
+		type.second.AddMemoryStats(&entry.m_Stats);
+		types.push_back(entry);
+	}
+
+	// Ties are ordered by name to keep reports comparable between runs
+	std::sort(types.begin(), types.end(), [](const TypeMemoryStats& left, const TypeMemoryStats& right) {
+		const size_t leftBytes = left.m_Stats.GetTotalBytes();
+		const size_t rightBytes = right.m_Stats.GetTotalBytes();
+		return leftBytes != rightBytes ? leftBytes > rightBytes : left.m_Name < right.m_Name;
+	});
+	return types;
+}
+
+void Reflection::WriteMemoryReport(std::ostream& stream, size_t typeCount) {
+
+	const MemoryStats stats = GetMemoryStats();
+	const std::vector<TypeMemoryStats> types = GetTypeMemoryStats();
+	const std::ios::fmtflags flags = stream.flags();
+	const std::streamsize precision = stream.precision();
+	const char fill = stream.fill();
+
+	const size_t totalBytes = stats.GetTotalBytes();
+	stream << "Reflection memory: " << totalBytes << " bytes, " << stats.m_TypeCount << " types, " << stats.m_MethodCount << " methods, "
+		<< stats.m_MemberCount << " members, " << stats.m_GlobalCount << " globals, " << stats.m_MetaDataCount << " meta data\n";
+
+	const std::pair<const char*, size_t> categories[] = {
+		{ "type infos", stats.m_TypeInfoBytes },
+		{ "method infos", stats.m_MethodInfoBytes },
+		{ "member infos", stats.m_MemberInfoBytes },
+		{ "globals", stats.m_GlobalBytes },
+		{ "delegates", stats.m_DelegateBytes },
+		{ "meta data", stats.m_MetaDataBytes },
+		{ "any values", stats.m_AnyBytes },
+		{ "hash tables", stats.m_HashTableBytes },
+		{ "pools", stats.m_PoolBytes }
+	};
+
+	stream << std::left << std::setw(24) << "category" << std::right << std::setw(12) << "bytes" << std::setw(8) << "%" << "\n";
+	for (const auto& category : categories) {
+		stream << std::left << std::setw(24) << category.first << std::right << std::setw(12) << category.second
+			<< std::setw(8) << std::fixed << std::setprecision(1) << (totalBytes > 0 ? category.second * 100.0 / totalBytes : 0.0) << "\n";
+	}
+
+	const size_t writtenCount = typeCount == 0 ? types.size() : std::min(typeCount, types.size());
+	stream << "\nLargest types: " << writtenCount << " of " << types.size() << "\n";
+	stream << std::left << std::setw(24) << "type" << std::right
+		<< std::setw(12) << "bytes" << std::setw(12) << "infos" << std::setw(12) << "delegates" << std::setw(12) << "meta"
+		<< std::setw(12) << "tables" << std::setw(12) << "pool" << std::setw(8) << "methods" << std::setw(8) << "members" << "\n";
+
+	for (size_t i = 0; i < writtenCount; ++i) {
+
+		// Types are only known by the hash of their name
+		const MemoryStats& type = types[i].m_Stats;
+		stream << "0x" << std::hex << std::setfill('0') << std::setw(sizeof(HashID::ValueType) * 2) << types[i].m_Name
+			<< std::dec << std::setfill(fill) << std::setw(24 - 2 - sizeof(HashID::ValueType) * 2) << ""
+			<< std::setw(12) << type.GetTotalBytes() << std::setw(12) << type.m_TypeInfoBytes + type.m_MethodInfoBytes + type.m_MemberInfoBytes
+			<< std::setw(12) << type.m_DelegateBytes << std::setw(12) << type.m_MetaDataBytes + type.m_AnyBytes
+			<< std::setw(12) << type.m_HashTableBytes << std::setw(12) << type.m_PoolBytes
+			<< std::setw(8) << type.m_MethodCount << std::setw(8) << type.m_MemberCount << "\n";
+	}
+
+	stream.flags(flags);
+	stream.precision(precision);
+	stream.fill(fill);
+}
+
 void Merge(Reflection&& left, Reflection* output) {
 
+	Reflection* sources[] = { &left };
+	MergeReport report = Merge(sources, 1, output, 1);
+
+	// Names collided, use the multi source Merge to retrieve and resolve the conflicts
+	MIST_ASSERT(report.HasConflicts() == false);
+}
+
+namespace {
+
+	const size_t MERGE_KIND_COUNT = 3;
+
+	// Name of an entry to merge, the position of the entry in its list determines its precedence
+	struct MergeEntry {
+		HashID::ValueType m_Name;
+		size_t m_Owner;
+	};
+
+	template< typename MapType >
+	void CollectMergeEntries(const MapType& map, size_t owner, std::vector<MergeEntry>* entries) {
+
+		for (const auto& entry : map) {
+			entries->push_back({ entry.first, owner });
+		}
+	}
+
+	// Move the entries of source that aren't in conflict into output, the rejected entries are left in source.
+	// attach(name, entry) is invoked on every moved entry to index its meta data
+	// @Detail: isConflict is read from cursor onward in the order the entries were collected
+	template< typename MapType, typename AttachType >
+	size_t MoveMergeEntries(MapType* source, MapType* output, const std::vector<char>& isConflict, size_t* cursor, AttachType attach) {
+
+		size_t moved = 0;
+		for (auto entry = source->begin(); entry != source->end();) {
+			if (isConflict[(*cursor)++] == 0) {
+				auto result = output->emplace(entry->first, std::move(entry->second));
+				attach(result.first->first, &result.first->second);
+				entry = source->erase(entry);
+				++moved;
+			}
+			else {
+				++entry;
+			}
+		}
+		return moved;
+	}
+}
+
+MergeReport Merge(Reflection* const* sources, size_t sourceCount, Reflection* output, size_t threadCount) {
+
 	MIST_ASSERT(output != nullptr);
+	MIST_ASSERT(sources != nullptr || sourceCount == 0);
+
+	// A frozen registry can't receive new entries
+	MIST_ASSERT(output->IsFrozen() == false);
 
-#if MIST_DEBUG
+	std::lock_guard<std::recursive_mutex> lock(output->m_WriteLock);
 
-	size_t typeCount = output->GetTypes()->size();
-	size_t functionCount = output->GetGlobalFunctions()->size();
-	size_t objectCount = output->GetGlobalObjects()->size();
+	// Gather every name, the destination's names first so that they take precedence
+	std::vector<MergeEntry> entries[MERGE_KIND_COUNT];
+	size_t destinationCounts[MERGE_KIND_COUNT] = { output->m_Types.size(), output->m_GlobalFunctions.size(), output->m_GlobalObjects.size() };
+	for (size_t kind = 0; kind < MERGE_KIND_COUNT; ++kind) {
+		entries[kind].reserve(destinationCounts[kind]);
+	}
 
-#endif
+	CollectMergeEntries(output->m_Types, MergeConflict::DESTINATION, &entries[0]);
+	CollectMergeEntries(output->m_GlobalFunctions, MergeConflict::DESTINATION, &entries[1]);
+	CollectMergeEntries(output->m_GlobalObjects, MergeConflict::DESTINATION, &entries[2]);
+	for (size_t source = 0; source < sourceCount; ++source) {
 
-	// merge the typeinfos
-	for (auto& typeInfo : *left.GetTypes()) {
+		MIST_ASSERT(sources[source] != nullptr && sources[source] != output);
+		CollectMergeEntries(sources[source]->m_Types, source, &entries[0]);
+		CollectMergeEntries(sources[source]->m_GlobalFunctions, source, &entries[1]);
+		CollectMergeEntries(sources[source]->m_GlobalObjects, source, &entries[2]);
+	}
 
-		auto result = output->GetTypes()->emplace(typeInfo.first, std::move(typeInfo.second));
-		MIST_ASSERT(result.second);
+	// Split the names in shards by value, equal names always land in the same shard
+	if (threadCount == 0) {
+		threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
 	}
+	const size_t shardCount = threadCount * 4;
 
-	// merge the global functions
-	for (auto& globalFunction : *left.GetGlobalFunctions()) {
+	std::vector<std::vector<size_t>> shards(MERGE_KIND_COUNT * shardCount);
+	for (size_t kind = 0; kind < MERGE_KIND_COUNT; ++kind) {
+		for (size_t i = 0; i < entries[kind].size(); ++i) {
+			shards[kind * shardCount + entries[kind][i].m_Name % shardCount].push_back(i);
+		}
+	}
 
-		auto result = output->GetGlobalFunctions()->emplace(globalFunction.first, std::move(globalFunction.second));
-		MIST_ASSERT(result.second);
+	// Detect the collisions of every shard in parallel, each shard only writes to the flags of its own entries
+	std::vector<char> isConflict[MERGE_KIND_COUNT];
+	for (size_t kind = 0; kind < MERGE_KIND_COUNT; ++kind) {
+		isConflict[kind].resize(entries[kind].size(), 0);
 	}
 
-	// merge the global objects
-	for (auto& globalObjects : *left.GetGlobalObjects()) {
+	std::vector<std::vector<MergeConflict>> shardConflicts(shards.size());
+	Detail::ParallelFor(shards.size(), threadCount, [&](size_t begin, size_t end) {
+
+		for (size_t shard = begin; shard < end; ++shard) {
 
-		auto result = output->GetGlobalObjects()->emplace(globalObjects.first, std::move(globalObjects.second));
-		MIST_ASSERT(result.second);
+			const size_t kind = shard / shardCount;
+			const std::vector<MergeEntry>& kindEntries = entries[kind];
+			std::vector<size_t>& indices = shards[shard];
+
+			// Order by name, then by precedence
+			std::sort(indices.begin(), indices.end(), [&kindEntries](size_t left, size_t right) {
+				return kindEntries[left].m_Name != kindEntries[right].m_Name ? kindEntries[left].m_Name < kindEntries[right].m_Name : left < right;
+			});
+
+			size_t owner = 0;
+			for (size_t i = 0; i < indices.size(); ++i) {
+
+				const MergeEntry& entry = kindEntries[indices[i]];
+				if (i == 0 || entry.m_Name != kindEntries[indices[owner]].m_Name) {
+					owner = i;
+					continue;
+				}
+
+				isConflict[kind][indices[i]] = 1;
+				shardConflicts[shard].push_back({ static_cast<MergeConflict::Kind>(kind), entry.m_Name, entry.m_Owner, kindEntries[indices[owner]].m_Owner });
+			}
+		}
+	});
+
+	MergeReport report;
+	for (const auto& conflicts : shardConflicts) {
+		report.m_Conflicts.insert(report.m_Conflicts.end(), conflicts.begin(), conflicts.end());
 	}
 
-#if MIST_DEBUG
+	// Size the destination once for every merged entry
+	output->m_Types.reserve(entries[0].size());
+	output->m_GlobalFunctions.reserve(entries[1].size());
+	output->m_GlobalObjects.reserve(entries[2].size());
+
+	// Source that provided each merged deferred registration, for reporting conflicts between sources
+	std::unordered_map<HashID::ValueType, size_t> deferredOwners;
+
+	size_t cursors[MERGE_KIND_COUNT] = { destinationCounts[0], destinationCounts[1], destinationCounts[2] };
+	for (size_t source = 0; source < sourceCount; ++source) {
+
+		Reflection* reflection = sources[source];
+		// Moved infos are indexed by output, methods and members are detached from the source as they're attached
+		auto attach = [output](HashID::ValueType name, auto* entry) { output->AttachMetaData(name, entry); };
+		const size_t mergedTypeCount = MoveMergeEntries(&reflection->m_Types, &output->m_Types, isConflict[0], &cursors[0], attach);
+		report.m_MergedTypeCount += mergedTypeCount;
+		if (mergedTypeCount > 0) {
+			reflection->m_TypeGeneration.fetch_add(1, std::memory_order_release);
+			output->m_TypeGeneration.fetch_add(1, std::memory_order_release);
+		}
+		report.m_MergedGlobalFunctionCount += MoveMergeEntries(&reflection->m_GlobalFunctions, &output->m_GlobalFunctions, isConflict[1], &cursors[1], attach);
+		report.m_MergedGlobalObjectCount += MoveMergeEntries(&reflection->m_GlobalObjects, &output->m_GlobalObjects, isConflict[2], &cursors[2], attach);
+
+		// The published entries of the source were moved out, lookups fall back to the remaining entries
+		reflection->m_Snapshot.store(nullptr, std::memory_order_release);
+
+		for (auto deferred = reflection->m_Deferred.begin(); deferred != reflection->m_Deferred.end();) {
+
+			// Check before emplacing, a failed emplace would still move the registration out of the source
+			if (output->m_Deferred.find(deferred->first) == output->m_Deferred.end()) {
+				output->m_Deferred.emplace(deferred->first, std::move(deferred->second));
+				deferredOwners.emplace(deferred->first, source);
+				deferred = reflection->m_Deferred.erase(deferred);
+				--reflection->m_DeferredCount;
+				++output->m_DeferredCount;
+				++report.m_MergedDeferredCount;
+			}
+			else {
+				auto owner = deferredOwners.find(deferred->first);
+				report.m_Conflicts.push_back({ MergeConflict::Kind::Deferred, deferred->first, source,
+					owner != deferredOwners.end() ? owner->second : MergeConflict::DESTINATION });
+				++deferred;
+			}
+		}
+	}
 
-	MIST_ASSERT(output->GetTypes()->size() == typeCount + left.GetTypes()->size());
-	MIST_ASSERT(output->GetGlobalFunctions()->size() == functionCount + left.GetGlobalFunctions()->size());
-	MIST_ASSERT(output->GetGlobalObjects()->size() == objectCount + left.GetGlobalObjects()->size());
+	// Report the conflicts in the same order regardless of the thread count
+	std::sort(report.m_Conflicts.begin(), report.m_Conflicts.end(), [](const MergeConflict& left, const MergeConflict& right) {
+		if (left.m_Kind != right.m_Kind) {
+			return left.m_Kind < right.m_Kind;
+		}
+		return left.m_Name != right.m_Name ? left.m_Name < right.m_Name : left.m_Source < right.m_Source;
+	});
 
-#endif
+	return report;
 }
 
-MIST_NAMESPACE_END
\ No newline at end of file
+MIST_NAMESPACE_END
@@ -0,0 +1,251 @@
+#include "../include/RegistrationProfiler.h"
+#include <Mist_Common/include/UtilityMacros.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <string>
+#include <thread>
+
+MIST_NAMESPACE
+
+namespace {
+
+#if MIST_PROFILE_REGISTRATION
+
+	struct ActiveRegistration {
+		const char* m_Name;
+		size_t m_Line;
+		std::chrono::steady_clock::time_point m_Start;
+		RegistrationCounters m_Counters;
+	};
+
+	std::vector<ActiveRegistration>& GetActiveRegistrations() {
+
+		static thread_local std::vector<ActiveRegistration> active;
+		return active;
+	}
+
+	uint64_t ToNanoseconds(std::chrono::steady_clock::duration duration) {
+
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+	}
+
+#endif
+
+	struct ProfilerState {
+		std::mutex m_Lock;
+		std::vector<RegistrationRecord> m_Records;
+		std::chrono::steady_clock::time_point m_Epoch = std::chrono::steady_clock::now();
+	};
+
+	// Created on first use since registrations run during static initialization
+	ProfilerState& GetState() {
+
+		static ProfilerState state;
+		return state;
+	}
+
+	// Retrieve the name of a record, registrations named by their source location are written as file:line
+	std::string GetRecordName(const RegistrationRecord& record) {
+
+		std::string name(record.m_Name);
+		if (record.m_Line != 0) {
+			name += ':' + std::to_string(record.m_Line);
+		}
+		return name;
+	}
+
+	// Write a string with the characters that JSON requires escaped
+	void WriteJsonString(std::ostream& stream, const char* string) {
+
+		stream << '"';
+		for (; *string != '\0'; ++string) {
+			const char character = *string;
+			if (character == '"' || character == '\\') {
+				stream << '\\' << character;
+			}
+			else if (static_cast<unsigned char>(character) < 0x20) {
+				stream << ' ';
+			}
+			else {
+				stream << character;
+			}
+		}
+		stream << '"';
+	}
+}
+
+void RegistrationProfiler::Begin(const char* name, size_t line) {
+
+#if MIST_PROFILE_REGISTRATION
+
+	// Touch the state first, its construction shouldn't be attributed to the registration
+	GetState();
+
+	std::vector<ActiveRegistration>& active = GetActiveRegistrations();
+	active.push_back({ name, line, std::chrono::steady_clock::now(), Detail::GetRegistrationCounters() });
+
+#else
+	(void)name;
+	(void)line;
+#endif
+}
+
+void RegistrationProfiler::End() {
+
+#if MIST_PROFILE_REGISTRATION
+
+	const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+	std::vector<ActiveRegistration>& active = GetActiveRegistrations();
+
+	// End was called without a matching Begin
+	MIST_ASSERT(active.empty() == false);
+
+	const ActiveRegistration& registration = active.back();
+	const RegistrationCounters& current = Detail::GetRegistrationCounters();
+	const RegistrationCounters& begin = registration.m_Counters;
+
+	RegistrationRecord record;
+	record.m_Name = registration.m_Name;
+	record.m_Line = registration.m_Line;
+	record.m_ThreadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+	record.m_Depth = active.size() - 1;
+	record.m_DurationNanoseconds = ToNanoseconds(end - registration.m_Start);
+	record.m_Counters.m_TypeCount = current.m_TypeCount - begin.m_TypeCount;
+	record.m_Counters.m_MethodCount = current.m_MethodCount - begin.m_MethodCount;
+	record.m_Counters.m_MemberCount = current.m_MemberCount - begin.m_MemberCount;
+	record.m_Counters.m_MetaDataCount = current.m_MetaDataCount - begin.m_MetaDataCount;
+	record.m_Counters.m_GlobalFunctionCount = current.m_GlobalFunctionCount - begin.m_GlobalFunctionCount;
+	record.m_Counters.m_GlobalObjectCount = current.m_GlobalObjectCount - begin.m_GlobalObjectCount;
+	record.m_Counters.m_AllocatedBytes = current.m_AllocatedBytes - begin.m_AllocatedBytes;
+	record.m_Counters.m_AllocationCount = current.m_AllocationCount - begin.m_AllocationCount;
+
+	ProfilerState& state = GetState();
+	record.m_StartNanoseconds = ToNanoseconds(registration.m_Start - state.m_Epoch);
+	active.pop_back();
+
+	std::lock_guard<std::mutex> lock(state.m_Lock);
+	state.m_Records.push_back(record);
+
+#endif
+}
+
+std::vector<RegistrationRecord> RegistrationProfiler::GetRecords() {
+
+	ProfilerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.m_Lock);
+	return state.m_Records;
+}
+
+void RegistrationProfiler::Clear() {
+
+	ProfilerState& state = GetState();
+	std::lock_guard<std::mutex> lock(state.m_Lock);
+	state.m_Records.clear();
+}
+
+void RegistrationProfiler::WriteReport(std::ostream& stream) {
+
+	std::vector<RegistrationRecord> records = GetRecords();
+	const std::ios::fmtflags flags = stream.flags();
+	const std::streamsize precision = stream.precision();
+
+	std::stable_sort(records.begin(), records.end(), [](const RegistrationRecord& left, const RegistrationRecord& right) {
+		return left.m_DurationNanoseconds > right.m_DurationNanoseconds;
+	});
+
+	uint64_t totalNanoseconds = 0;
+	for (const RegistrationRecord& record : records) {
+		if (record.m_Depth == 0) {
+			totalNanoseconds += record.m_DurationNanoseconds;
+		}
+	}
+
+	stream << "Registration profile: " << records.size() << " registrations, "
+		<< std::fixed << std::setprecision(3) << totalNanoseconds / 1000000.0 << " ms\n";
+	stream << std::left << std::setw(48) << "registration" << std::right
+		<< std::setw(12) << "ms" << std::setw(8) << "types" << std::setw(8) << "methods" << std::setw(8) << "members"
+		<< std::setw(8) << "meta" << std::setw(8) << "globals" << std::setw(12) << "bytes" << std::setw(8) << "allocs" << "\n";
+
+	for (const RegistrationRecord& record : records) {
+		const RegistrationCounters& counters = record.m_Counters;
+		stream << std::left << std::setw(48) << GetRecordName(record) << std::right
+			<< std::setw(12) << record.m_DurationNanoseconds / 1000000.0
+			<< std::setw(8) << counters.m_TypeCount << std::setw(8) << counters.m_MethodCount << std::setw(8) << counters.m_MemberCount
+			<< std::setw(8) << counters.m_MetaDataCount << std::setw(8) << counters.m_GlobalFunctionCount + counters.m_GlobalObjectCount
+			<< std::setw(12) << counters.m_AllocatedBytes << std::setw(8) << counters.m_AllocationCount << "\n";
+	}
+
+	stream.flags(flags);
+	stream.precision(precision);
+}
+
+void RegistrationProfiler::WriteChromeTrace(std::ostream& stream) {
+
+	std::vector<RegistrationRecord> records = GetRecords();
+	const std::ios::fmtflags flags = stream.flags();
+	const std::streamsize precision = stream.precision();
+
+	stream << "{\"traceEvents\":[";
+	for (size_t i = 0; i < records.size(); ++i) {
+
+		const RegistrationRecord& record = records[i];
+		const RegistrationCounters& counters = record.m_Counters;
+
+		// Complete events are timed in microseconds
+		stream << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+		WriteJsonString(stream, GetRecordName(record).c_str());
+		stream << std::fixed << std::setprecision(3)
+			<< ",\"cat\":\"registration\",\"ph\":\"X\",\"pid\":0,\"tid\":" << record.m_ThreadId
+			<< ",\"ts\":" << record.m_StartNanoseconds / 1000.0
+			<< ",\"dur\":" << record.m_DurationNanoseconds / 1000.0
+			<< ",\"args\":{\"types\":" << counters.m_TypeCount
+			<< ",\"methods\":" << counters.m_MethodCount
+			<< ",\"members\":" << counters.m_MemberCount
+			<< ",\"metaData\":" << counters.m_MetaDataCount
+			<< ",\"globalFunctions\":" << counters.m_GlobalFunctionCount
+			<< ",\"globalObjects\":" << counters.m_GlobalObjectCount
+			<< ",\"allocatedBytes\":" << counters.m_AllocatedBytes
+			<< ",\"allocations\":" << counters.m_AllocationCount << "}}";
+	}
+	stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	stream.flags(flags);
+	stream.precision(precision);
+}
+
+MIST_NAMESPACE_END
+
+#if MIST_PROFILE_REGISTRATION && MIST_PROFILE_REGISTRATION_ALLOCATIONS
+
+// Count every allocation of the thread, registrations attribute the difference to themselves
+void* operator new(size_t size) {
+
+	Mist::RegistrationCounters& counters = Mist::Detail::GetRegistrationCounters();
+	counters.m_AllocatedBytes += size;
+	++counters.m_AllocationCount;
+
+	void* memory = std::malloc(size != 0 ? size : 1);
+	if (memory == nullptr) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void* memory) noexcept {
+
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+
+	std::free(memory);
+}
+
+#endif
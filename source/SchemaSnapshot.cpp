@@ -0,0 +1,533 @@
+#include "../include/SchemaSnapshot.h"
+#include "../include/Reflection.h"
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MIST_NAMESPACE
+
+static_assert(sizeof(SchemaType) == 64, "Schema records must not contain padding");
+static_assert(sizeof(SchemaMember) == 56, "Schema records must not contain padding");
+static_assert(sizeof(SchemaMethod) == 32, "Schema records must not contain padding");
+static_assert(sizeof(SchemaMetaData) == 32, "Schema records must not contain padding");
+static_assert(sizeof(Detail::SchemaHeader) == 96, "Schema records must not contain padding");
+
+namespace {
+
+	// Tables start on 8 byte boundaries
+	const size_t TABLE_ALIGNMENT = 8;
+
+	size_t AlignTable(size_t offset) {
+
+		return (offset + TABLE_ALIGNMENT - 1) / TABLE_ALIGNMENT * TABLE_ALIGNMENT;
+	}
+
+	// Records of a reflection before they are laid out in a snapshot
+	struct SchemaBuilder {
+
+		std::vector<SchemaType> m_Types;
+		std::vector<SchemaMember> m_Members;
+		std::vector<SchemaMethod> m_Methods;
+		std::vector<SchemaMetaData> m_MetaData;
+		// Starts with the empty string
+		std::string m_Strings = std::string(1, '\0');
+		std::vector<unsigned char> m_Data;
+
+		uint32_t AddString(const char* string) {
+
+			// The empty string is at offset 0
+			if (string == nullptr || *string == '\0') {
+				return 0;
+			}
+
+			const uint32_t offset = static_cast<uint32_t>(m_Strings.size());
+			m_Strings.append(string);
+			m_Strings.push_back('\0');
+			return offset;
+		}
+
+		// Entries are recorded in name order, which is the order lookups search them in
+		template< typename MapType >
+		static std::vector<std::pair<HashID::ValueType, typename MapType::mapped_type*>> SortByName(MapType& map) {
+
+			std::vector<std::pair<HashID::ValueType, typename MapType::mapped_type*>> entries;
+			entries.reserve(map.size());
+			for (auto& entry : map) {
+				entries.emplace_back(entry.first, &entry.second);
+			}
+			std::sort(entries.begin(), entries.end(), [](const std::pair<HashID::ValueType, typename MapType::mapped_type*>& left, const std::pair<HashID::ValueType, typename MapType::mapped_type*>& right) {
+				return left.first < right.first;
+			});
+			return entries;
+		}
+
+		void AddMetaData(MetaData* metaData, uint32_t* first, uint32_t* count) {
+
+			std::vector<std::pair<HashID::ValueType, const Any*>> entries;
+			for (auto& entry : *metaData) {
+				entries.emplace_back(entry.first, &entry.second);
+			}
+			std::sort(entries.begin(), entries.end(), [](const std::pair<HashID::ValueType, const Any*>& left, const std::pair<HashID::ValueType, const Any*>& right) {
+				return left.first < right.first;
+			});
+
+			*first = static_cast<uint32_t>(m_MetaData.size());
+			*count = static_cast<uint32_t>(entries.size());
+			for (const auto& entry : entries) {
+
+				const Any& value = *entry.second;
+				SchemaMetaData record = {};
+				record.m_Name = entry.first;
+				record.m_TypeHash = Detail::SchemaTypeHash(value.GetTypeId());
+				record.m_Size = value.GetSize();
+				record.m_DataOffset = SchemaMetaData::NO_DATA;
+
+				if (value.IsTriviallyCopyable()) {
+					m_Data.resize(AlignTable(m_Data.size()));
+					record.m_DataOffset = m_Data.size();
+					const unsigned char* bytes = static_cast<const unsigned char*>(value.GetData());
+					m_Data.insert(m_Data.end(), bytes, bytes + value.GetSize());
+				}
+				m_MetaData.push_back(record);
+			}
+		}
+
+		void Build(Reflection* reflection) {
+
+			reflection->MaterializeAll();
+
+			for (auto& type : SortByName(*reflection->GetTypes())) {
+
+				TypeInfo* typeInfo = type.second;
+				SchemaType typeRecord = {};
+				typeRecord.m_Name = type.first;
+				typeRecord.m_TypeHash = Detail::SchemaTypeHash(typeInfo->GetTypeId());
+				typeRecord.m_Size = typeInfo->GetSize();
+				typeRecord.m_Alignment = typeInfo->GetAlignment();
+				typeRecord.m_TypeName = AddString(typeInfo->GetTypeId().GetName());
+
+				auto members = SortByName(*typeInfo->GetMembers());
+				typeRecord.m_FirstMember = static_cast<uint32_t>(m_Members.size());
+				typeRecord.m_MemberCount = static_cast<uint32_t>(members.size());
+				for (auto& member : members) {
+
+					MemberInfo* memberInfo = member.second;
+					SchemaMember memberRecord = {};
+					memberRecord.m_Name = member.first;
+					memberRecord.m_TypeHash = Detail::SchemaTypeHash(memberInfo->GetTypeId());
+					memberRecord.m_Offset = memberInfo->HasOffset() ? memberInfo->GetOffset() : SchemaMember::NO_OFFSET;
+					memberRecord.m_Size = memberInfo->GetSize();
+					memberRecord.m_Alignment = memberInfo->GetAlignment();
+					memberRecord.m_MemberName = AddString(memberInfo->GetName());
+					AddMetaData(memberInfo->GetMetaData(), &memberRecord.m_FirstMetaData, &memberRecord.m_MetaDataCount);
+					m_Members.push_back(memberRecord);
+				}
+
+				auto methods = SortByName(*typeInfo->GetMethods());
+				typeRecord.m_FirstMethod = static_cast<uint32_t>(m_Methods.size());
+				typeRecord.m_MethodCount = static_cast<uint32_t>(methods.size());
+				for (auto& method : methods) {
+
+					MethodInfo* methodInfo = method.second;
+					SchemaMethod methodRecord = {};
+					methodRecord.m_Name = method.first;
+					methodRecord.m_SignatureHash = Detail::SchemaTypeHash(methodInfo->GetSignature());
+					methodRecord.m_Signature = AddString(methodInfo->GetSignature().GetName());
+					AddMetaData(methodInfo->GetMetaData(), &methodRecord.m_FirstMetaData, &methodRecord.m_MetaDataCount);
+					m_Methods.push_back(methodRecord);
+				}
+
+				AddMetaData(typeInfo->GetMetaData(), &typeRecord.m_FirstMetaData, &typeRecord.m_MetaDataCount);
+				m_Types.push_back(typeRecord);
+			}
+		}
+
+		// Lay the header and tables out into a snapshot
+		void Write(std::vector<unsigned char>* output) const {
+
+			Detail::SchemaHeader header = {};
+			header.m_Magic = Detail::SCHEMA_MAGIC;
+			header.m_Version = Detail::SCHEMA_VERSION;
+			header.m_HashIdSize = sizeof(HashID::ValueType);
+			header.m_PointerSize = sizeof(void*);
+			header.m_TypeCount = static_cast<uint32_t>(m_Types.size());
+			header.m_MemberCount = static_cast<uint32_t>(m_Members.size());
+			header.m_MethodCount = static_cast<uint32_t>(m_Methods.size());
+			header.m_MetaDataCount = static_cast<uint32_t>(m_MetaData.size());
+
+			header.m_TypesOffset = AlignTable(sizeof(header));
+			header.m_MembersOffset = AlignTable(header.m_TypesOffset + m_Types.size() * sizeof(SchemaType));
+			header.m_MethodsOffset = AlignTable(header.m_MembersOffset + m_Members.size() * sizeof(SchemaMember));
+			header.m_MetaDataOffset = AlignTable(header.m_MethodsOffset + m_Methods.size() * sizeof(SchemaMethod));
+			header.m_StringsOffset = AlignTable(header.m_MetaDataOffset + m_MetaData.size() * sizeof(SchemaMetaData));
+			header.m_DataOffset = AlignTable(header.m_StringsOffset + m_Strings.size());
+			header.m_FileSize = header.m_DataOffset + m_Data.size();
+
+			output->assign(static_cast<size_t>(header.m_FileSize), 0);
+			unsigned char* data = output->data();
+			if (m_Types.empty() == false) {
+				std::memcpy(data + header.m_TypesOffset, m_Types.data(), m_Types.size() * sizeof(SchemaType));
+			}
+			if (m_Members.empty() == false) {
+				std::memcpy(data + header.m_MembersOffset, m_Members.data(), m_Members.size() * sizeof(SchemaMember));
+			}
+			if (m_Methods.empty() == false) {
+				std::memcpy(data + header.m_MethodsOffset, m_Methods.data(), m_Methods.size() * sizeof(SchemaMethod));
+			}
+			if (m_MetaData.empty() == false) {
+				std::memcpy(data + header.m_MetaDataOffset, m_MetaData.data(), m_MetaData.size() * sizeof(SchemaMetaData));
+			}
+			std::memcpy(data + header.m_StringsOffset, m_Strings.data(), m_Strings.size());
+			if (m_Data.empty() == false) {
+				std::memcpy(data + header.m_DataOffset, m_Data.data(), m_Data.size());
+			}
+
+			// The fingerprint covers the layout, the values of the meta data aren't part of it
+			header.m_Fingerprint = djb2::Hash<uint64_t>(reinterpret_cast<const char*>(data + header.m_TypesOffset), static_cast<size_t>(header.m_DataOffset - header.m_TypesOffset));
+			std::memcpy(data, &header, sizeof(header));
+		}
+	};
+
+	// Find the record named name in a table sorted by name
+	template< typename RecordType >
+	const RecordType* FindRecord(const RecordType* records, uint32_t count, HashID name) {
+
+		const uint64_t key = name.GetValue();
+		const RecordType* found = std::lower_bound(records, records + count, key, [](const RecordType& record, uint64_t value) {
+			return record.m_Name < value;
+		});
+		return found != records + count && found->m_Name == key ? found : nullptr;
+	}
+
+	// Determine if the range [first, first + count) is within a table of size records
+	bool IsInTable(uint32_t first, uint32_t count, uint32_t size) {
+
+		return first <= size && count <= size - first;
+	}
+
+	// Determine if a table of count records starting at offset ends before next
+	// @Detail: Both offsets must already be within the file, the table size is compared to the room left so nothing wraps
+	bool IsTableBefore(uint64_t offset, uint32_t count, size_t recordSize, uint64_t next) {
+
+		return offset <= next && uint64_t(count) * recordSize <= next - offset;
+	}
+}
+
+bool WriteSchemaSnapshot(Reflection* reflection, const char* path) {
+
+	MIST_ASSERT(reflection != nullptr);
+
+	SchemaBuilder builder;
+	builder.Build(reflection);
+
+	std::vector<unsigned char> snapshot;
+	builder.Write(&snapshot);
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(snapshot.data()), snapshot.size());
+	return static_cast<bool>(file);
+}
+
+uint64_t ComputeSchemaFingerprint(Reflection* reflection) {
+
+	MIST_ASSERT(reflection != nullptr);
+
+	std::lock_guard<std::recursive_mutex> lock(reflection->m_WriteLock);
+
+	// Running the deferred registrations changes the generation, materialize before comparing
+	reflection->MaterializeAll();
+	const size_t generation = reflection->GetSchemaGeneration();
+	if (reflection->m_SchemaFingerprintGeneration == generation) {
+		return reflection->m_SchemaFingerprint;
+	}
+
+	SchemaBuilder builder;
+	builder.Build(reflection);
+
+	std::vector<unsigned char> snapshot;
+	builder.Write(&snapshot);
+
+	reflection->m_SchemaFingerprint = reinterpret_cast<const Detail::SchemaHeader*>(snapshot.data())->m_Fingerprint;
+	reflection->m_SchemaFingerprintGeneration = generation;
+	return reflection->m_SchemaFingerprint;
+}
+
+bool SchemaSnapshot::Open(const char* path) {
+
+	Close();
+
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(file, &size) == FALSE || size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void* data = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (data == nullptr) {
+		if (mapping != nullptr) {
+			CloseHandle(mapping);
+		}
+		CloseHandle(file);
+		return false;
+	}
+
+	m_File = file;
+	m_Mapping = mapping;
+	m_Data = static_cast<const unsigned char*>(data);
+	m_Size = static_cast<size_t>(size.QuadPart);
+#else
+	const int file = open(path, O_RDONLY);
+	if (file < 0) {
+		return false;
+	}
+
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0) {
+		close(file);
+		return false;
+	}
+
+	// The mapping keeps the file alive, the descriptor isn't needed afterwards
+	void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (data == MAP_FAILED) {
+		return false;
+	}
+
+	m_Mapping = data;
+	m_Data = static_cast<const unsigned char*>(data);
+	m_Size = static_cast<size_t>(status.st_size);
+#endif
+
+	if (Validate() == false) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool SchemaSnapshot::Open(const void* data, size_t size) {
+
+	Close();
+
+	// Records are read in place
+	MIST_ASSERT(reinterpret_cast<uintptr_t>(data) % TABLE_ALIGNMENT == 0);
+
+	m_Data = static_cast<const unsigned char*>(data);
+	m_Size = size;
+
+	if (Validate() == false) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void SchemaSnapshot::Close() {
+
+#if defined(_WIN32)
+	if (m_Mapping != nullptr) {
+		UnmapViewOfFile(m_Data);
+		CloseHandle(m_Mapping);
+		CloseHandle(m_File);
+	}
+#else
+	if (m_Mapping != nullptr) {
+		munmap(m_Mapping, m_Size);
+	}
+#endif
+
+	m_Data = nullptr;
+	m_Size = 0;
+	m_Header = nullptr;
+	m_Mapping = nullptr;
+	m_File = nullptr;
+}
+
+bool SchemaSnapshot::IsOpen() const {
+
+	return m_Header != nullptr;
+}
+
+uint64_t SchemaSnapshot::GetFingerprint() const {
+
+	MIST_ASSERT(IsOpen());
+	return m_Header->m_Fingerprint;
+}
+
+bool SchemaSnapshot::Matches(Reflection* reflection) const {
+
+	return Matches(ComputeSchemaFingerprint(reflection));
+}
+
+bool SchemaSnapshot::Matches(uint64_t fingerprint) const {
+
+	return IsOpen() && m_Header->m_Fingerprint == fingerprint;
+}
+
+const SchemaType* SchemaSnapshot::FindType(HashID name) const {
+
+	MIST_ASSERT(IsOpen());
+	return FindRecord(GetTypes(), m_Header->m_TypeCount, name);
+}
+
+const SchemaType* SchemaSnapshot::GetTypes() const {
+
+	MIST_ASSERT(IsOpen());
+	return GetTable<SchemaType>(m_Header->m_TypesOffset);
+}
+
+size_t SchemaSnapshot::GetTypeCount() const {
+
+	MIST_ASSERT(IsOpen());
+	return m_Header->m_TypeCount;
+}
+
+const SchemaMember* SchemaSnapshot::FindMember(const SchemaType& type, HashID name) const {
+
+	return FindRecord(GetMembers(type), type.m_MemberCount, name);
+}
+
+const SchemaMember* SchemaSnapshot::GetMembers(const SchemaType& type) const {
+
+	MIST_ASSERT(IsOpen());
+	return GetTable<SchemaMember>(m_Header->m_MembersOffset) + type.m_FirstMember;
+}
+
+const SchemaMethod* SchemaSnapshot::FindMethod(const SchemaType& type, HashID name) const {
+
+	return FindRecord(GetMethods(type), type.m_MethodCount, name);
+}
+
+const SchemaMethod* SchemaSnapshot::GetMethods(const SchemaType& type) const {
+
+	MIST_ASSERT(IsOpen());
+	return GetTable<SchemaMethod>(m_Header->m_MethodsOffset) + type.m_FirstMethod;
+}
+
+const char* SchemaSnapshot::GetString(uint32_t offset) const {
+
+	MIST_ASSERT(IsOpen());
+	MIST_ASSERT(offset < m_Header->m_DataOffset - m_Header->m_StringsOffset);
+	return reinterpret_cast<const char*>(m_Data + m_Header->m_StringsOffset + offset);
+}
+
+SchemaSnapshot::SchemaSnapshot()
+	: m_Data(nullptr)
+	, m_Size(0)
+	, m_Header(nullptr)
+	, m_Mapping(nullptr)
+	, m_File(nullptr) {
+}
+
+SchemaSnapshot::~SchemaSnapshot() {
+
+	Close();
+}
+
+bool SchemaSnapshot::Validate() {
+
+	if (m_Size < sizeof(Detail::SchemaHeader)) {
+		return false;
+	}
+
+	const Detail::SchemaHeader* header = reinterpret_cast<const Detail::SchemaHeader*>(m_Data);
+	if (header->m_Magic != Detail::SCHEMA_MAGIC || header->m_Version != Detail::SCHEMA_VERSION
+		|| header->m_HashIdSize != sizeof(HashID::ValueType) || header->m_PointerSize != sizeof(void*)
+		|| header->m_FileSize != m_Size) {
+		return false;
+	}
+
+	// Tables must be within the file before their ranges are computed, offsets near the top of the range would wrap
+	if (header->m_TypesOffset > m_Size || header->m_MembersOffset > m_Size || header->m_MethodsOffset > m_Size
+		|| header->m_MetaDataOffset > m_Size || header->m_StringsOffset > m_Size || header->m_DataOffset > m_Size) {
+		return false;
+	}
+
+	// Tables must be in order, each ending before the next one starts
+	if (header->m_TypesOffset < sizeof(Detail::SchemaHeader)
+		|| IsTableBefore(header->m_TypesOffset, header->m_TypeCount, sizeof(SchemaType), header->m_MembersOffset) == false
+		|| IsTableBefore(header->m_MembersOffset, header->m_MemberCount, sizeof(SchemaMember), header->m_MethodsOffset) == false
+		|| IsTableBefore(header->m_MethodsOffset, header->m_MethodCount, sizeof(SchemaMethod), header->m_MetaDataOffset) == false
+		|| IsTableBefore(header->m_MetaDataOffset, header->m_MetaDataCount, sizeof(SchemaMetaData), header->m_StringsOffset) == false
+		|| header->m_DataOffset < header->m_StringsOffset) {
+		return false;
+	}
+
+	// Records are read in place, every table must start on a table boundary
+	if (header->m_TypesOffset % TABLE_ALIGNMENT != 0 || header->m_MembersOffset % TABLE_ALIGNMENT != 0
+		|| header->m_MethodsOffset % TABLE_ALIGNMENT != 0 || header->m_MetaDataOffset % TABLE_ALIGNMENT != 0) {
+		return false;
+	}
+
+	// Strings are null terminated, the last one included
+	const uint64_t stringsSize = header->m_DataOffset - header->m_StringsOffset;
+	if (stringsSize == 0 || m_Data[header->m_DataOffset - 1] != '\0') {
+		return false;
+	}
+
+	// Every range must be within its table, stale or truncated snapshots would otherwise read out of bounds
+	const uint64_t dataSize = m_Size - header->m_DataOffset;
+	const SchemaMetaData* metaData = reinterpret_cast<const SchemaMetaData*>(m_Data + header->m_MetaDataOffset);
+	for (uint32_t i = 0; i < header->m_MetaDataCount; ++i) {
+		if (metaData[i].m_DataOffset != SchemaMetaData::NO_DATA && (metaData[i].m_DataOffset > dataSize || metaData[i].m_Size > dataSize - metaData[i].m_DataOffset)) {
+			return false;
+		}
+	}
+
+	const SchemaMethod* methods = reinterpret_cast<const SchemaMethod*>(m_Data + header->m_MethodsOffset);
+	for (uint32_t i = 0; i < header->m_MethodCount; ++i) {
+		if (IsInTable(methods[i].m_FirstMetaData, methods[i].m_MetaDataCount, header->m_MetaDataCount) == false || methods[i].m_Signature >= stringsSize) {
+			return false;
+		}
+	}
+
+	const SchemaMember* members = reinterpret_cast<const SchemaMember*>(m_Data + header->m_MembersOffset);
+	for (uint32_t i = 0; i < header->m_MemberCount; ++i) {
+		if (IsInTable(members[i].m_FirstMetaData, members[i].m_MetaDataCount, header->m_MetaDataCount) == false || members[i].m_MemberName >= stringsSize) {
+			return false;
+		}
+	}
+
+	const SchemaType* types = reinterpret_cast<const SchemaType*>(m_Data + header->m_TypesOffset);
+	for (uint32_t i = 0; i < header->m_TypeCount; ++i) {
+		if (IsInTable(types[i].m_FirstMember, types[i].m_MemberCount, header->m_MemberCount) == false
+			|| IsInTable(types[i].m_FirstMethod, types[i].m_MethodCount, header->m_MethodCount) == false
+			|| IsInTable(types[i].m_FirstMetaData, types[i].m_MetaDataCount, header->m_MetaDataCount) == false
+			|| types[i].m_TypeName >= stringsSize) {
+			return false;
+		}
+	}
+
+	m_Header = header;
+	return true;
+}
+
+const SchemaMetaData* SchemaSnapshot::FindMetaData(uint32_t first, uint32_t count, HashID name) const {
+
+	MIST_ASSERT(IsOpen());
+	return FindRecord(GetTable<SchemaMetaData>(m_Header->m_MetaDataOffset) + first, count, name);
+}
+
+MIST_NAMESPACE_END
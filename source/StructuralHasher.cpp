@@ -0,0 +1,108 @@
+#include "../include/StructuralHasher.h"
+#include "../Mist_hashing/include/Hashing.h"
+#include <cstring>
+#include <string>
+
+MIST_NAMESPACE
+
+namespace {
+
+	// Fold the hash of a step into the hash of the object, the order of the steps matters
+	uint64_t Combine(uint64_t hash, uint64_t value) {
+
+		return hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2));
+	}
+
+	uint64_t HashString(const std::string& string) {
+
+		return djb2::Hash<uint64_t>(string.data(), string.size());
+	}
+
+	bool EqualStrings(const std::string& left, const std::string& right) {
+
+		return left == right;
+	}
+}
+
+uint64_t StructuralHasher::Hash(const void* object, TypeInfo* type) {
+
+	MIST_ASSERT(object != nullptr);
+	MIST_ASSERT(type != nullptr);
+
+	const Detail::Layout* layout = m_Layouts.Get(type->GetTypeId());
+	return layout != nullptr ? HashLayout(*layout, static_cast<const unsigned char*>(object)) : 0;
+}
+
+bool StructuralHasher::Equals(const void* left, const void* right, TypeInfo* type) {
+
+	MIST_ASSERT(left != nullptr && right != nullptr);
+	MIST_ASSERT(type != nullptr);
+
+	const Detail::Layout* layout = m_Layouts.Get(type->GetTypeId());
+	return layout != nullptr && EqualsLayout(*layout, static_cast<const unsigned char*>(left), static_cast<const unsigned char*>(right));
+}
+
+StructuralHasher::StructuralHasher(Reflection* reflection)
+	: m_Layouts(reflection) {
+
+	AddFunctions<std::string>(&HashString, &EqualStrings);
+}
+
+uint64_t StructuralHasher::HashLayout(const Detail::Layout& layout, const unsigned char* object) {
+
+	uint64_t hash = djb2::Detail::BEGIN_HASH_VALUE;
+	for (const Detail::LayoutRun& run : layout.m_Runs) {
+
+		const Detail::LayoutField& field = layout.m_Fields[run.m_FirstField];
+		const unsigned char* source = object + field.m_Offset;
+		switch (field.m_Kind) {
+		case Detail::LayoutField::Kind::Bytes:
+			hash = Combine(hash, djb2::Hash<uint64_t>(reinterpret_cast<const char*>(source), run.m_Size));
+			break;
+
+		case Detail::LayoutField::Kind::Custom:
+			hash = Combine(hash, static_cast<Detail::StructuralFunctions*>(field.m_Custom)->m_Hash.Invoke<uint64_t, const void*>(source));
+			break;
+
+		case Detail::LayoutField::Kind::Member:
+			hash = Combine(hash, HashLayout(*field.m_Layout, static_cast<const unsigned char*>(field.m_Member->Resolve(static_cast<const void*>(source)))));
+			break;
+		}
+	}
+	return hash;
+}
+
+bool StructuralHasher::EqualsLayout(const Detail::Layout& layout, const unsigned char* left, const unsigned char* right) {
+
+	for (const Detail::LayoutRun& run : layout.m_Runs) {
+
+		const Detail::LayoutField& field = layout.m_Fields[run.m_FirstField];
+		const unsigned char* leftValue = left + field.m_Offset;
+		const unsigned char* rightValue = right + field.m_Offset;
+		switch (field.m_Kind) {
+		case Detail::LayoutField::Kind::Bytes:
+			if (std::memcmp(leftValue, rightValue, run.m_Size) != 0) {
+				return false;
+			}
+			break;
+
+		case Detail::LayoutField::Kind::Custom:
+			if (static_cast<Detail::StructuralFunctions*>(field.m_Custom)->m_Equals.Invoke<bool, const void*, const void*>(leftValue, rightValue) == false) {
+				return false;
+			}
+			break;
+
+		case Detail::LayoutField::Kind::Member: {
+			const unsigned char* leftMember = static_cast<const unsigned char*>(field.m_Member->Resolve(static_cast<const void*>(leftValue)));
+			const unsigned char* rightMember = static_cast<const unsigned char*>(field.m_Member->Resolve(static_cast<const void*>(rightValue)));
+			if (EqualsLayout(*field.m_Layout, leftMember, rightMember) == false) {
+				return false;
+			}
+			break;
+		}
+		}
+	}
+	return true;
+}
+
+MIST_NAMESPACE_END
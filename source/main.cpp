@@ -1,11 +1,36 @@
+#include <cstddef>
 #include <iostream>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "../include/TypeId.h"
 #include "../include/Type.h"
 #include "../include/Delegate.h"
+#include "../include/Any.h"
 #include "../include/MetaData.h"
 #include "../include/MethodInfo.h"
 #include "../include/MemberInfo.h"
 #include "../include/TypeInfo.h"
 #include "../include/Reflection.h"
+#include "../include/RegistrationProfiler.h"
+#include "../include/PreMain.h"
+#include "../include/BinarySerializer.h"
+#include "../include/JsonSerializer.h"
+#include "../include/ObjectDiff.h"
+#include "../include/StructuralHasher.h"
+#include "../include/SchemaSnapshot.h"
 
 size_t g_SomeGlobal = 10;
 
@@ -19,6 +44,26 @@ size_t ReturnNumber(size_t num) {
 	return num;
 }
 
+size_t ConsumeNumber(std::unique_ptr<size_t> num) {
+	return *num;
+}
+
+// Counts the copies and moves made of any instance
+struct CopyCounter {
+
+	CopyCounter() = default;
+	CopyCounter(const CopyCounter&) { ++s_Copies; }
+	CopyCounter(CopyCounter&&) { ++s_Moves; }
+
+	static void Reset() { s_Copies = 0; s_Moves = 0; }
+
+	static size_t s_Copies;
+	static size_t s_Moves;
+};
+
+size_t CopyCounter::s_Copies = 0;
+size_t CopyCounter::s_Moves = 0;
+
 void TestReflection() {
 
 	std::cout << "Reflection Test" << std::endl;
@@ -35,36 +80,78 @@ void TestReflection() {
 
 	MIST_ASSERT(type.Is<int>() == false);
 	MIST_ASSERT(type.Is<float>());
+	MIST_ASSERT(type.GetId() == Mist::TypeId::Get<float>());
+
+	// -TypeId-
+
+	MIST_ASSERT(Mist::TypeId().IsValid() == false);
+	MIST_ASSERT(Mist::TypeId::Get<int>() == Mist::TypeId::Get<int>());
+	MIST_ASSERT(Mist::TypeId::Get<int>() != Mist::TypeId::Get<const int>());
+	MIST_ASSERT((Mist::TypeId::Get<int, float>()) != Mist::TypeId::Get<int>());
+	MIST_ASSERT(Mist::TypeId::Get<size_t(size_t)>() != Mist::TypeId::Get<size_t()>());
+	MIST_ASSERT(Mist::TypeId::Get<int>().GetName()[0] != '\0');
 
-	std::unique_ptr<Mist::Detail::Callback> callback(Mist::Detail::MakeCallback(Pause));
-	MIST_ASSERT(Mist::Detail::HasDefinition<void>(callback.get()));
-	MIST_ASSERT((Mist::Detail::HasDefinition<size_t, size_t>(callback.get())) == false);
+	// -HashID-
+
+	using namespace Mist::Literals;
+
+	static_assert(Mist::djb2::Hash("") == 5381, "An empty string hashes to the initial value");
+	static_assert(Mist::djb2::Hash("a") == 5381 * 33 + 'a', "Each character is added to the hash multiplied by 33");
+	static_assert(Mist::HashID("TypeName").GetValue() == ("TypeName"_hash).GetValue(), "Literal ids must match constructed ids");
+	static_assert(MIST_HASHID("TypeName").GetValue() == Mist::HashID("TypeName").GetValue(), "Compile time ids must match constructed ids");
+	static_assert(Mist::djb2::Hash<uint64_t>("TypeName") != Mist::djb2::Hash<uint32_t>("TypeName"), "64 bit hashes keep the high bits");
+
+	// Hashing runtime strings must match hashing the literal for every remainder of the 8 character blocks
+	const char* hashedNames[] = { "", "a", "Mist", "Reflect", "Reflecti", "Reflection", "ReflectionReflection!", "An_Extremely_Long_Reflected_Type_Name_Used_By_Data_Files" };
+	for (const char* hashedName : hashedNames) {
+		std::string runtimeName(hashedName);
+		MIST_ASSERT(Mist::HashID(runtimeName.c_str(), runtimeName.size()).GetValue() == Mist::HashID(hashedName).GetValue());
+		MIST_ASSERT((Mist::djb2::Hash<uint64_t>(runtimeName.c_str(), runtimeName.size())) == Mist::djb2::Hash<uint64_t>(hashedName));
+	}
 
 	// -Callback-
 
+	Mist::Delegate callback(Pause);
+	MIST_ASSERT(callback.HasSignature<void>());
+	MIST_ASSERT((callback.HasSignature<size_t, size_t>()) == false);
+	MIST_ASSERT(callback.IsInline());
+
 	const size_t CHANGE_TARGET = 1;
 	size_t changed;
-	std::unique_ptr<Mist::Detail::Callback> lambda(Mist::Detail::MakeCallback([=,&changed]() { changed = CHANGE_TARGET; }));
+	Mist::Delegate lambda([=,&changed]() { changed = CHANGE_TARGET; });
 
-	MIST_ASSERT(Mist::Detail::HasDefinition<void>(lambda.get()));
-	MIST_ASSERT((Mist::Detail::HasDefinition<size_t, size_t>(lambda.get())) == false);
+	MIST_ASSERT(lambda.HasSignature<void>());
+	MIST_ASSERT((lambda.HasSignature<size_t, size_t>()) == false);
+	MIST_ASSERT(lambda.GetSignature() == Mist::TypeId::Get<void()>());
 
-	Mist::Detail::CallbackInterface<void>* call = Mist::Detail::Cast<void>(lambda.get());
-	call->Invoke();
+	lambda.Invoke();
 
 	MIST_ASSERT(changed == CHANGE_TARGET);
 
 	changed = 0;
 	auto l = [&changed](size_t j) { changed = j; };
-	std::unique_ptr<Mist::Detail::Callback> savedLambda(Mist::Detail::MakeCallback(l));
+	Mist::Delegate savedLambda(l);
 
-	MIST_ASSERT((Mist::Detail::HasDefinition<void, size_t>(savedLambda.get())));
-	MIST_ASSERT((Mist::Detail::HasDefinition<size_t, size_t>(savedLambda.get())) == false);
+	MIST_ASSERT((savedLambda.HasSignature<void, size_t>()));
+	MIST_ASSERT((savedLambda.HasSignature<size_t, size_t>()) == false);
 
-	Mist::Detail::CallbackInterface<void, size_t>* c = Mist::Detail::Cast<void, size_t>(savedLambda.get());
-	c->Invoke(CHANGE_TARGET);
+	Mist::Delegate movedLambda(std::move(savedLambda));
+	movedLambda.Invoke<void, size_t>(CHANGE_TARGET);
 
 	MIST_ASSERT(changed == CHANGE_TARGET);
+	MIST_ASSERT(savedLambda.GetSignature().IsValid() == false);
+
+	struct LargeCapture {
+		size_t m_Values[8] = {};
+	};
+
+	LargeCapture largeCapture;
+	largeCapture.m_Values[7] = CHANGE_TARGET;
+	Mist::Delegate largeLambda([largeCapture]() { return largeCapture.m_Values[7]; });
+	MIST_ASSERT(largeLambda.IsInline() == false);
+
+	movedLambda = std::move(largeLambda);
+	MIST_ASSERT(movedLambda.Invoke<size_t>() == CHANGE_TARGET);
 	
 	// -Delegate-
 
@@ -87,12 +174,43 @@ void TestReflection() {
 
 	MIST_ASSERT(data == CHANGE_TARGET);
 
+	// -Any-
+
+	struct LargeValue {
+		size_t m_Values[16] = {};
+	};
+
+	Mist::Any smallAny(size_t(5));
+	MIST_ASSERT(smallAny.IsInline());
+	MIST_ASSERT(smallAny.Is<size_t>());
+	MIST_ASSERT(*smallAny.Get<size_t>() == 5);
+
+	Mist::Any largeAny(LargeValue{});
+	MIST_ASSERT(Mist::Any::FitsInline<LargeValue>() == false);
+	MIST_ASSERT(largeAny.IsInline() == false);
+	largeAny.Get<LargeValue>()->m_Values[15] = 5;
+
+	Mist::Any movedAny(std::move(smallAny));
+	MIST_ASSERT(movedAny.IsInline());
+	MIST_ASSERT(*movedAny.Get<size_t>() == 5);
+
+	movedAny = std::move(largeAny);
+	MIST_ASSERT(movedAny.Is<LargeValue>());
+	MIST_ASSERT(movedAny.Get<LargeValue>()->m_Values[15] == 5);
+
+	movedAny.Set(1.0f);
+	MIST_ASSERT(movedAny.IsInline());
+	MIST_ASSERT(*movedAny.Get<float>() == 1.0f);
+
 	// MetaData
 
 	const size_t META_DATA_VALUE = 5;
 	
 	Mist::MetaData metaData;
 
+	// Meta data is its inline entries, which the heap block pointer shares, the index it's attached to and two counts
+	MIST_ASSERT(sizeof(Mist::MetaData) == sizeof(Mist::MetaData::Entry) * MIST_METADATA_INLINE_CAPACITY + sizeof(void*) + 2 * sizeof(uint32_t));
+	MIST_ASSERT(metaData.begin() == metaData.end());
 	MIST_ASSERT(metaData.Has("Lol") == false);
 	MIST_ASSERT((*metaData.Add<size_t>("Foo", META_DATA_VALUE)) == META_DATA_VALUE);
 	MIST_ASSERT(metaData.Has("Foo"));
@@ -112,6 +230,29 @@ void TestReflection() {
 
 	MIST_ASSERT(metaData.Add(Mist::HashID(1), TestClass())->data == META_DATA_VALUE);
 	MIST_ASSERT(metaData.Has(Mist::HashID(1)));
+
+	// Inline entries are moved along with the meta data
+	Mist::MetaData small;
+	small.Add("Small", META_DATA_VALUE);
+	Mist::MetaData movedSmall(std::move(small));
+	MIST_ASSERT(small.Size() == 0 && small.Has("Small") == false);
+	MIST_ASSERT(*movedSmall.Get<size_t>("Small") == META_DATA_VALUE);
+
+	// Entries spill past the inline ones, are iterated in id order and keep their address when moved
+	Mist::MetaData grown;
+	for (size_t i = 0; i < 9; ++i) {
+		grown.Add(Mist::HashID(static_cast<Mist::HashID::ValueType>(100 - i)), i);
+	}
+	MIST_ASSERT(grown.Size() == 9);
+	MIST_ASSERT(std::is_sorted(grown.begin(), grown.end(), [](const Mist::MetaData::Entry& left, const Mist::MetaData::Entry& right) { return left.first < right.first; }));
+
+	size_t* grownValue = grown.Get<size_t>(Mist::HashID(100));
+	Mist::MetaData movedMetaData(std::move(grown));
+	MIST_ASSERT(grown.Size() == 0 && grown.Has(Mist::HashID(100)) == false);
+	MIST_ASSERT(movedMetaData.Get<size_t>(Mist::HashID(100)) == grownValue);
+	for (size_t i = 0; i < 9; ++i) {
+		MIST_ASSERT(*movedMetaData.Get<size_t>(Mist::HashID(static_cast<Mist::HashID::ValueType>(100 - i))) == i);
+	}
 	MIST_ASSERT(metaData.Get<TestClass>(Mist::HashID(1))->data == META_DATA_VALUE);
 	
 	// -MethodInfo-
@@ -132,6 +273,94 @@ void TestReflection() {
 	Mist::MethodInfo repeatMethod(&TestMethodInfo::Repeat);
 	MIST_ASSERT(repeatMethod.Invoke<size_t>(&obj, CHANGE_TARGET) == CHANGE_TARGET);
 
+	Mist::MethodInfo::Bound<size_t, TestMethodInfo, size_t> boundRepeat = repeatMethod.Bind<size_t, TestMethodInfo, size_t>();
+	static_assert(std::is_trivially_copyable<decltype(boundRepeat)>::value, "Bound methods must be trivially copyable");
+	MIST_ASSERT(boundRepeat.IsValid());
+	MIST_ASSERT(boundRepeat(&obj, CHANGE_TARGET) == CHANGE_TARGET);
+	MIST_ASSERT((repeatMethod.Bind<void, TestMethodInfo, size_t>().IsValid()) == false);
+
+	// -MethodInfo Batch-
+
+	struct Ticker {
+		void Tick(float delta) { m_Time += delta; }
+		float m_Time = 0.0f;
+	};
+
+	const size_t TICKER_COUNT = 257;
+	std::vector<Ticker> tickers(TICKER_COUNT);
+	std::vector<Ticker*> tickerPointers;
+	std::vector<float> deltas;
+	std::vector<size_t> repeated(TICKER_COUNT);
+	std::vector<TestMethodInfo*> repeatObjects(TICKER_COUNT, &obj);
+	std::vector<size_t> repeatValues;
+	for (size_t i = 0; i < TICKER_COUNT; ++i) {
+		tickerPointers.push_back(&tickers[i]);
+		deltas.push_back(static_cast<float>(i));
+		repeatValues.push_back(i);
+	}
+
+	Mist::MethodInfo tick(&Ticker::Tick);
+	tick.InvokeBatch<void, Ticker, float>(tickerPointers.data(), TICKER_COUNT, nullptr, deltas.data());
+	tick.InvokeBatchParallel<void, Ticker, float>(4, tickerPointers.data(), TICKER_COUNT, nullptr, deltas.data());
+	for (size_t i = 0; i < TICKER_COUNT; ++i) {
+		MIST_ASSERT(tickers[i].m_Time == static_cast<float>(i) * 2.0f);
+	}
+
+	repeatMethod.InvokeBatchParallel<size_t, TestMethodInfo, size_t>(0, repeatObjects.data(), TICKER_COUNT, repeated.data(), repeatValues.data());
+	MIST_ASSERT(repeated == repeatValues);
+
+	// Reference parameters read from arrays of their decayed type
+	struct Labeler {
+		size_t Label(const std::string& label) { return m_Count += label.size(); }
+		size_t m_Count = 0;
+	};
+
+	std::vector<Labeler> labelers(TICKER_COUNT);
+	std::vector<Labeler*> labelerPointers;
+	std::vector<std::string> labels;
+	for (size_t i = 0; i < TICKER_COUNT; ++i) {
+		labelerPointers.push_back(&labelers[i]);
+		labels.push_back(std::string(i % 7, 'x'));
+	}
+
+	std::vector<size_t> labeled(TICKER_COUNT);
+	Mist::MethodInfo label(&Labeler::Label);
+	label.InvokeBatch<size_t, Labeler, const std::string&>(labelerPointers.data(), TICKER_COUNT, labeled.data(), labels.data());
+	label.InvokeBatchParallel<size_t, Labeler, const std::string&>(3, labelerPointers.data(), TICKER_COUNT, labeled.data(), labels.data());
+	for (size_t i = 0; i < TICKER_COUNT; ++i) {
+		MIST_ASSERT(labeled[i] == 2 * (i % 7) && labelers[i].m_Count == 2 * (i % 7));
+	}
+
+	// Parallel loops run on the persistent worker pool and can be nested
+	std::atomic<size_t> nestedSum(0);
+	Mist::Detail::ParallelFor(8, 4, [&nestedSum](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			Mist::Detail::ParallelFor(16, 4, [&nestedSum](size_t innerBegin, size_t innerEnd) {
+				nestedSum += innerEnd - innerBegin;
+			});
+		}
+	});
+	MIST_ASSERT(nestedSum == 8 * 16);
+	MIST_ASSERT(Mist::Detail::WorkerPool::Get().GetWorkerCount() > 0);
+
+	// Exceptions thrown by queued chunks and by the chunk of the calling thread are rethrown once every chunk is complete
+	for (size_t throwingChunk : { size_t(0), size_t(3) }) {
+		std::atomic<size_t> completedChunks(0);
+		bool rethrown = false;
+		try {
+			Mist::Detail::ParallelFor(4, 4, [&completedChunks, throwingChunk](size_t begin, size_t) {
+				if (begin == throwingChunk) {
+					throw std::runtime_error("Chunk failed");
+				}
+				++completedChunks;
+			});
+		}
+		catch (const std::runtime_error&) {
+			rethrown = true;
+		}
+		MIST_ASSERT(rethrown && completedChunks == 3);
+	}
+
 	Mist::MetaData* meta = repeatMethod.GetMetaData();
 	meta->Add<size_t>("Property", CHANGE_TARGET);
 
@@ -149,6 +378,69 @@ void TestReflection() {
 
 	MIST_ASSERT(*memberMera->Get<size_t>("Property") == CHANGE_TARGET);
 
+	struct LayoutTest {
+		char m_Flag = 0;
+		double m_Value = 0.0;
+	};
+
+	LayoutTest layoutTest;
+	Mist::MemberInfo layoutMember(&LayoutTest::m_Value);
+	MIST_ASSERT(layoutMember.HasOffset());
+	MIST_ASSERT(layoutMember.GetOffset() == offsetof(LayoutTest, m_Value));
+	MIST_ASSERT(layoutMember.GetSize() == sizeof(double));
+	MIST_ASSERT(layoutMember.GetAlignment() == alignof(double));
+	MIST_ASSERT(layoutMember.GetTypeId() == Mist::TypeId::Get<double>());
+	MIST_ASSERT(layoutMember.GetClassTypeId() == Mist::TypeId::Get<LayoutTest>());
+	MIST_ASSERT(layoutMember.GetAddress(&layoutTest) == &layoutTest.m_Value);
+	MIST_ASSERT(layoutMember.Get<double>(&layoutTest) == &layoutTest.m_Value);
+
+	struct NonStandardLayout {
+		virtual ~NonStandardLayout() = default;
+		size_t m_Value = CHANGE_TARGET;
+	};
+
+	NonStandardLayout nonStandard;
+	Mist::MemberInfo nonStandardMember(&NonStandardLayout::m_Value);
+	MIST_ASSERT(nonStandardMember.HasOffset() == false);
+	MIST_ASSERT(*nonStandardMember.Get<size_t>(&nonStandard) == CHANGE_TARGET);
+
+	// The member pointer moves with the info
+	Mist::MemberInfo movedNonStandardMember(std::move(nonStandardMember));
+	MIST_ASSERT(movedNonStandardMember.Resolve(&nonStandard) == &nonStandard.m_Value);
+
+	// -MemberInfo Batch-
+
+	const size_t BATCH_COUNT = 37;
+	LayoutTest layoutObjects[BATCH_COUNT];
+	LayoutTest* layoutPointers[BATCH_COUNT];
+	double values[BATCH_COUNT];
+	for (size_t i = 0; i < BATCH_COUNT; ++i) {
+		layoutObjects[i].m_Value = static_cast<double>(i);
+		layoutPointers[i] = &layoutObjects[BATCH_COUNT - 1 - i];
+	}
+
+	layoutMember.GatherStrided(layoutObjects, sizeof(LayoutTest), BATCH_COUNT, values);
+	for (size_t i = 0; i < BATCH_COUNT; ++i) {
+		MIST_ASSERT(values[i] == static_cast<double>(i));
+		values[i] *= 2.0;
+	}
+
+	layoutMember.ScatterStrided(layoutObjects, sizeof(LayoutTest), BATCH_COUNT, values);
+	MIST_ASSERT(layoutObjects[BATCH_COUNT - 1].m_Value == static_cast<double>(BATCH_COUNT - 1) * 2.0);
+
+	layoutMember.Gather(layoutPointers, BATCH_COUNT, values);
+	MIST_ASSERT(values[0] == static_cast<double>(BATCH_COUNT - 1) * 2.0);
+	MIST_ASSERT(values[BATCH_COUNT - 1] == 0.0);
+
+	values[0] = 1.0;
+	layoutMember.Scatter(layoutPointers, 1, values);
+	MIST_ASSERT(layoutObjects[BATCH_COUNT - 1].m_Value == 1.0);
+
+	NonStandardLayout* nonStandardPointers[] = { &nonStandard };
+	size_t nonStandardValues[1] = {};
+	nonStandardMember.Gather(nonStandardPointers, 1, nonStandardValues);
+	MIST_ASSERT(nonStandardValues[0] == CHANGE_TARGET);
+
 
 	// -TypeInfo-
 
@@ -225,7 +517,138 @@ void TestReflection() {
 
 	d = nonDefaultType.Create<NonDefault>();
 	MIST_ASSERT(d != nullptr);
-	delete d;
+	nonDefaultType.Destroy(d);
+
+	MIST_ASSERT(nonDefaultType.GetSize() == sizeof(NonDefault));
+	MIST_ASSERT(nonDefaultType.GetAlignment() == alignof(NonDefault));
+	MIST_ASSERT((nonDefaultType.HasConstructor<NonDefault, size_t>()));
+	MIST_ASSERT((nonDefaultType.HasConstructor<NonDefault, float>()) == false);
+
+	// Construct in caller provided memory
+	typename std::aligned_storage<sizeof(NonDefault), alignof(NonDefault)>::type nonDefaultStorage;
+	d = nonDefaultType.CreateAt<NonDefault>(&nonDefaultStorage, CHANGE_TARGET + 1);
+	MIST_ASSERT(d == reinterpret_cast<NonDefault*>(&nonDefaultStorage));
+	MIST_ASSERT(d->m_Data == CHANGE_TARGET + 1);
+	nonDefaultType.DestroyAt(d);
+
+	d = nonDefaultType.CreateAt<NonDefault>(&nonDefaultStorage);
+	MIST_ASSERT(d != nullptr && d->m_Data == CHANGE_TARGET);
+	nonDefaultType.DestroyAt(d);
+
+	MIST_ASSERT(nonDefaultType.CreateAt<NonDefault>(&nonDefaultStorage, 1.0f) == nullptr);
+
+	// Pooled creation recycles the storage of destroyed instances
+	MIST_ASSERT(nonDefaultType.IsPooled() == false);
+	nonDefaultType.EnablePool(2);
+	MIST_ASSERT(nonDefaultType.IsPooled());
+
+	NonDefault* pooled[3];
+	for (size_t i = 0; i < 3; ++i) {
+		pooled[i] = nonDefaultType.Create<NonDefault>(i);
+		MIST_ASSERT(pooled[i] != nullptr && pooled[i]->m_Data == i);
+		MIST_ASSERT(reinterpret_cast<uintptr_t>(pooled[i]) % alignof(NonDefault) == 0);
+	}
+
+	Mist::PoolStats poolStats = nonDefaultType.GetPoolStats();
+	MIST_ASSERT(poolStats.m_LiveCount == 3 && poolStats.m_Capacity == 4 && poolStats.m_SlabCount == 2);
+
+	nonDefaultType.Destroy(pooled[1]);
+	MIST_ASSERT(nonDefaultType.GetPoolStats().m_LiveCount == 2);
+	MIST_ASSERT(nonDefaultType.Create<NonDefault>() == pooled[1]);
+
+	for (NonDefault* instance : pooled) {
+		nonDefaultType.Destroy(instance);
+	}
+
+	poolStats = nonDefaultType.GetPoolStats();
+	MIST_ASSERT(poolStats.m_LiveCount == 0 && poolStats.m_PeakLiveCount == 3 && poolStats.m_SlabCount == 2);
+
+	// A throwing constructor returns its slot to the pool
+	struct ThrowingConstructor {
+		explicit ThrowingConstructor(bool isThrowing) {
+			if (isThrowing) {
+				throw std::runtime_error("ThrowingConstructor");
+			}
+		}
+	};
+
+	Mist::Type throwingDefinition;
+	throwingDefinition.DefineTypes<ThrowingConstructor>();
+
+	Mist::TypeInfo throwingType(std::move(throwingDefinition));
+	throwingType.AddConstructor<ThrowingConstructor, bool>();
+	throwingType.EnablePool(1);
+
+	bool isThrown = false;
+	try {
+		throwingType.Create<ThrowingConstructor>(true);
+	}
+	catch (const std::runtime_error&) {
+		isThrown = true;
+	}
+	MIST_ASSERT(isThrown && throwingType.GetPoolStats().m_LiveCount == 0);
+
+	ThrowingConstructor* constructed = throwingType.Create<ThrowingConstructor>(false);
+	MIST_ASSERT(constructed != nullptr && throwingType.GetPoolStats().m_SlabCount == 1);
+	throwingType.Destroy(constructed);
+
+	// -Forwarding-
+
+	CopyCounter counter;
+
+	Mist::Delegate byReference([](const CopyCounter&) {});
+	CopyCounter::Reset();
+	byReference.Invoke<void, const CopyCounter&>(counter);
+	MIST_ASSERT(CopyCounter::s_Copies == 0 && CopyCounter::s_Moves == 0);
+
+	// Lvalues are copied once into a value parameter, rvalues are only moved
+	Mist::Delegate byValue([](CopyCounter) {});
+	CopyCounter::Reset();
+	byValue.Invoke<void>(counter);
+	MIST_ASSERT(CopyCounter::s_Copies == 1);
+	CopyCounter::Reset();
+	byValue.Invoke<void>(std::move(counter));
+	MIST_ASSERT(CopyCounter::s_Copies == 0);
+
+	size_t referenced = 0;
+	Mist::Delegate byMutableReference([](size_t& value) { value = CHANGE_TARGET; });
+	byMutableReference.Invoke<void, size_t&>(referenced);
+	MIST_ASSERT(referenced == CHANGE_TARGET);
+
+	Mist::Delegate moveOnly(&ConsumeNumber);
+	MIST_ASSERT(moveOnly.Invoke<size_t>(std::unique_ptr<size_t>(new size_t(CHANGE_TARGET))) == CHANGE_TARGET);
+
+	struct ForwardTarget {
+
+		ForwardTarget() = default;
+		ForwardTarget(CopyCounter counter) : m_Counter(std::move(counter)) {}
+
+		size_t Read(const CopyCounter&) { return CHANGE_TARGET; }
+		size_t Consume(std::unique_ptr<size_t> value) { return *value; }
+
+		CopyCounter m_Counter;
+	};
+
+	ForwardTarget forwardTarget;
+	Mist::MethodInfo readMethod(&ForwardTarget::Read);
+	CopyCounter::Reset();
+	MIST_ASSERT((readMethod.Invoke<size_t, ForwardTarget, const CopyCounter&>(&forwardTarget, counter)) == CHANGE_TARGET);
+	MIST_ASSERT((readMethod.Bind<size_t, ForwardTarget, const CopyCounter&>()(&forwardTarget, counter)) == CHANGE_TARGET);
+	MIST_ASSERT(CopyCounter::s_Copies == 0 && CopyCounter::s_Moves == 0);
+
+	Mist::MethodInfo consumeMethod(&ForwardTarget::Consume);
+	MIST_ASSERT(consumeMethod.Invoke<size_t>(&forwardTarget, std::unique_ptr<size_t>(new size_t(CHANGE_TARGET))) == CHANGE_TARGET);
+
+	Mist::Type forwardType;
+	forwardType.DefineTypes<ForwardTarget>();
+	Mist::TypeInfo forwardTypeInfo(std::move(forwardType));
+	forwardTypeInfo.AddConstructor<ForwardTarget, CopyCounter>();
+
+	CopyCounter::Reset();
+	ForwardTarget* forwardCreated = forwardTypeInfo.Create<ForwardTarget>(std::move(counter));
+	MIST_ASSERT(forwardCreated != nullptr);
+	MIST_ASSERT(CopyCounter::s_Copies == 0);
+	delete forwardCreated;
 
 	Mist::Reflection reflection;
 	Mist::TypeInfo* reflectedType = reflection.AddType<NonDefault>("NonDefault");
@@ -243,6 +666,23 @@ void TestReflection() {
 
 	MIST_ASSERT((global->Invoke<size_t, size_t>(CHANGE_TARGET)) == CHANGE_TARGET);
 
+	Mist::GlobalFunction* consumeGlobal = reflection.AddGlobalFunction("ConsumeNumber", &ConsumeNumber);
+	MIST_ASSERT(consumeGlobal->Invoke<size_t>(std::unique_ptr<size_t>(new size_t(CHANGE_TARGET))) == CHANGE_TARGET);
+
+	Mist::BoundDelegate<size_t, size_t> boundGlobal = global->Bind<size_t, size_t>();
+	MIST_ASSERT(boundGlobal.IsValid());
+	MIST_ASSERT(boundGlobal(CHANGE_TARGET) == CHANGE_TARGET);
+	MIST_ASSERT((global->Bind<size_t>().IsValid()) == false);
+
+	std::vector<size_t> globalInputs = { 1, 2, 3 };
+	std::vector<size_t> globalResults(globalInputs.size());
+	global->InvokeBatch<size_t, size_t>(globalInputs.size(), globalResults.data(), globalInputs.data());
+	MIST_ASSERT(globalResults == globalInputs);
+
+	std::fill(globalResults.begin(), globalResults.end(), 0);
+	global->InvokeBatchParallel<size_t, size_t>(2, globalInputs.size(), globalResults.data(), globalInputs.data());
+	MIST_ASSERT(globalResults == globalInputs);
+
 	Mist::GlobalObject* gAny = reflection.AddGlobalObject("Any", &g_SomeGlobal);
 	gAny->GetMetaData()->Add("Meta", (size_t)10);
 	MIST_ASSERT(*gAny->GetMetaData()->Get<size_t>("Meta") == 10);
@@ -258,6 +698,755 @@ void TestReflection() {
 	global = mergedTarget.GetGlobalFunction("ReturnNumber");
 	MIST_ASSERT((global->Invoke<size_t, size_t>(CHANGE_TARGET)) == CHANGE_TARGET);
 
+	// -Deferred Registration-
+
+	Mist::Reflection lazy;
+	std::atomic<size_t> registrationCount(0);
+	lazy.DeferType<NonDefault>("Lazy", [&registrationCount](Mist::TypeInfo* type) {
+		type->AddConstructor<NonDefault>();
+		++registrationCount;
+	});
+	lazy.Defer("LazyFunction", Mist::Delegate([](Mist::Reflection* reflection) {
+		reflection->AddGlobalFunction("LazyFunction", &ReturnNumber);
+	}));
+
+	MIST_ASSERT(lazy.GetDeferredCount() == 2);
+	MIST_ASSERT(lazy.GetTypes()->empty());
+	MIST_ASSERT(lazy.GetType("Lazy")->HasConstructor<NonDefault>());
+	MIST_ASSERT(lazy.GetType("Lazy") != nullptr && registrationCount == 1);
+	MIST_ASSERT(lazy.GetDeferredCount() == 1);
+	MIST_ASSERT(lazy.Materialize("Lazy") == false);
+
+	lazy.MaterializeAll();
+	MIST_ASSERT(lazy.GetDeferredCount() == 0);
+	MIST_ASSERT(lazy.GetGlobalFunctions()->size() == 1);
+
+	// Concurrent first lookups of a published registry run every registration once
+	const size_t LAZY_TYPE_COUNT = 32;
+	Mist::Reflection concurrentLazy;
+	registrationCount = 0;
+	for (size_t i = 0; i < LAZY_TYPE_COUNT; ++i) {
+		std::string name = "Lazy" + std::to_string(i);
+		concurrentLazy.DeferType<NonDefault>(Mist::HashID(name.c_str(), name.size()), [&registrationCount](Mist::TypeInfo* type) {
+			type->AddConstructor<NonDefault>();
+			++registrationCount;
+		});
+	}
+	concurrentLazy.Publish();
+
+	std::vector<std::thread> lazyReaders;
+	for (size_t i = 0; i < 4; ++i) {
+		lazyReaders.emplace_back([&]() {
+			for (size_t j = 0; j < LAZY_TYPE_COUNT; ++j) {
+				std::string name = "Lazy" + std::to_string(j);
+				Mist::TypeInfo* type = concurrentLazy.GetType(Mist::HashID(name.c_str(), name.size()));
+				MIST_ASSERT(type->IsFrozen() && type->HasConstructor<NonDefault>());
+			}
+		});
+	}
+	for (auto& reader : lazyReaders) {
+		reader.join();
+	}
+	MIST_ASSERT(registrationCount == LAZY_TYPE_COUNT);
+	MIST_ASSERT(concurrentLazy.GetDeferredCount() == 0);
+
+	// Types materialized after publishing are found before the snapshot is republished
+	Mist::Reflection batchedLazy;
+	for (size_t i = 0; i < 4; ++i) {
+		std::string name = "Batched" + std::to_string(i);
+		batchedLazy.AddType<NonDefault>(Mist::HashID(name.c_str(), name.size()));
+	}
+	batchedLazy.DeferType<NonDefault>("BatchedLazy", [](Mist::TypeInfo* type) { type->AddConstructor<NonDefault>(); });
+	batchedLazy.Publish();
+	Mist::TypeInfo* batchedType = batchedLazy.GetType("BatchedLazy");
+	MIST_ASSERT(batchedType->IsFrozen() && batchedType->HasConstructor<NonDefault>());
+	MIST_ASSERT(batchedLazy.GetType("BatchedLazy") == batchedType);
+	batchedLazy.Publish();
+	MIST_ASSERT(batchedLazy.GetType("BatchedLazy") == batchedType);
+
+	// -Merge Report-
+
+	Mist::Reflection firstModule;
+	Mist::Reflection secondModule;
+	Mist::Reflection thirdModule;
+	firstModule.AddType<NonDefault>("Shared");
+	firstModule.AddGlobalFunction("FirstFunction", &ReturnNumber);
+	secondModule.AddType<NonDefault>("Shared");
+	secondModule.AddType<NonDefault>("SecondOnly");
+	thirdModule.AddGlobalFunction("ReturnNumber", &ReturnNumber);
+	thirdModule.AddGlobalObject("ThirdObject", &g_SomeGlobal);
+	thirdModule.DeferType<NonDefault>("ThirdDeferred", [](Mist::TypeInfo*) {});
+
+	Mist::Reflection* modules[] = { &firstModule, &secondModule, &thirdModule };
+	Mist::MergeReport report = Mist::Merge(modules, 3, &mergedTarget, 4);
+
+	MIST_ASSERT(report.HasConflicts());
+	MIST_ASSERT(report.m_Conflicts.size() == 2);
+	MIST_ASSERT(report.m_MergedTypeCount == 2 && report.m_MergedGlobalFunctionCount == 1 && report.m_MergedGlobalObjectCount == 1);
+
+	const Mist::MergeConflict& typeConflict = report.m_Conflicts[0];
+	MIST_ASSERT(typeConflict.m_Kind == Mist::MergeConflict::Kind::Type);
+	MIST_ASSERT(typeConflict.m_Name == Mist::HashID("Shared").GetValue());
+	MIST_ASSERT(typeConflict.m_Source == 1 && typeConflict.m_Owner == 0);
+
+	const Mist::MergeConflict& functionConflict = report.m_Conflicts[1];
+	MIST_ASSERT(functionConflict.m_Kind == Mist::MergeConflict::Kind::GlobalFunction);
+	MIST_ASSERT(functionConflict.m_Source == 2 && functionConflict.m_Owner == Mist::MergeConflict::DESTINATION);
+
+	// Rejected entries stay in their source
+	MIST_ASSERT(secondModule.GetTypes()->size() == 1 && secondModule.GetTypes()->count(Mist::HashID("Shared").GetValue()) == 1);
+	MIST_ASSERT(thirdModule.GetGlobalFunctions()->size() == 1 && thirdModule.GetGlobalObjects()->empty());
+	MIST_ASSERT(firstModule.GetTypes()->empty());
+	MIST_ASSERT(mergedTarget.GetType("SecondOnly") != nullptr);
+	MIST_ASSERT(*mergedTarget.GetGlobalObject("ThirdObject")->Get<size_t>() == 10);
+	MIST_ASSERT(report.m_MergedDeferredCount == 1 && thirdModule.GetDeferredCount() == 0);
+	MIST_ASSERT(mergedTarget.GetType("ThirdDeferred") != nullptr);
+
+	// -Freeze-
+
+	Mist::TypeInfo* nonDefaultInfo = mergedTarget.GetType("NonDefault");
+	nonDefaultInfo->GetMetaData()->Add("Frozen", CHANGE_TARGET);
+	mergedTarget.Freeze();
+	MIST_ASSERT(mergedTarget.IsFrozen());
+	MIST_ASSERT(nonDefaultInfo->IsFrozen());
+
+	// Pointers retrieved before freezing remain valid
+	MIST_ASSERT(mergedTarget.GetType("NonDefault") == nonDefaultInfo);
+	MIST_ASSERT(mergedTarget.GetGlobalFunction("ReturnNumber") == global);
+	MIST_ASSERT(*mergedTarget.GetGlobalObject("Any")->Get<size_t>() == 10);
+	MIST_ASSERT(*mergedTarget.GetGlobalFunction("ReturnNumber")->GetMetaData()->Get<size_t>("Meta") == 10);
+	MIST_ASSERT(nonDefaultInfo->GetMetaData()->IsFrozen());
+	MIST_ASSERT(*nonDefaultInfo->GetMetaData()->Get<size_t>("Frozen") == CHANGE_TARGET);
+	MIST_ASSERT(nonDefaultInfo->GetMetaData()->Has("Missing") == false);
+
+	// -Publish-
+
+	// Readers resolve published entries while a writer registers and publishes new ones
+	Mist::Reflection concurrent;
+	concurrent.AddType<NonDefault>("Published")->AddConstructor<NonDefault>();
+	MIST_ASSERT(concurrent.IsPublished() == false);
+	concurrent.Publish();
+	MIST_ASSERT(concurrent.IsPublished());
+	Mist::TypeInfo* published = concurrent.GetType("Published");
+
+	const size_t PUBLISHED_TYPE_COUNT = 64;
+	std::atomic<size_t> publishedCount(0);
+	std::atomic<bool> publishing(true);
+
+	std::vector<std::thread> readers;
+	for (size_t i = 0; i < 4; ++i) {
+		readers.emplace_back([&]() {
+			while (publishing.load()) {
+				MIST_ASSERT(concurrent.GetType("Published") == published);
+
+				size_t visible = publishedCount.load();
+				if (visible > 0) {
+					std::string name = "Published" + std::to_string(visible - 1);
+					MIST_ASSERT(concurrent.GetType(Mist::HashID(name.c_str(), name.size()))->HasConstructor<NonDefault>());
+				}
+			}
+		});
+	}
+
+	for (size_t i = 0; i < PUBLISHED_TYPE_COUNT; ++i) {
+		std::string name = "Published" + std::to_string(i);
+		concurrent.AddType<NonDefault>(Mist::HashID(name.c_str(), name.size()))->AddConstructor<NonDefault>();
+		concurrent.Publish();
+		publishedCount.store(i + 1);
+	}
+
+	publishing.store(false);
+	for (auto& reader : readers) {
+		reader.join();
+	}
+	MIST_ASSERT(concurrent.GetType("Published") == published);
+
+	// -Registration Profiler-
+
+	Mist::RegistrationProfiler::Clear();
+	Mist::Reflection profiled;
+	Mist::PreMainCall profiledRegister("ProfiledRegister", [&profiled]() {
+		Mist::TypeInfo* info = profiled.AddType<TestMethodInfo>("Profiled");
+		info->AddMember("m_Value", &TestMethodInfo::m_Value);
+		info->AddMethod("Repeat", &TestMethodInfo::Repeat);
+		info->GetMetaData()->Add("Meta", CHANGE_TARGET);
+		profiled.AddGlobalObject("ProfiledObject", &g_SomeGlobal);
+	});
+
+	std::vector<Mist::RegistrationRecord> records = Mist::RegistrationProfiler::GetRecords();
+#if MIST_PROFILE_REGISTRATION
+	MIST_ASSERT(records.size() == 1);
+	MIST_ASSERT(std::string(records[0].m_Name) == "ProfiledRegister" && records[0].m_Depth == 0);
+	MIST_ASSERT(records[0].m_Counters.m_TypeCount == 1 && records[0].m_Counters.m_MemberCount == 1);
+	MIST_ASSERT(records[0].m_Counters.m_MethodCount == 1 && records[0].m_Counters.m_MetaDataCount == 1);
+	MIST_ASSERT(records[0].m_Counters.m_GlobalObjectCount == 1 && records[0].m_Counters.m_GlobalFunctionCount == 0);
+
+#if MIST_PROFILE_REGISTRATION_ALLOCATIONS
+	MIST_ASSERT(records[0].m_Counters.m_AllocatedBytes > 0 && records[0].m_Counters.m_AllocationCount > 0);
+#endif
+
+	std::ostringstream trace;
+	Mist::RegistrationProfiler::WriteChromeTrace(trace);
+	MIST_ASSERT(trace.str().find("\"name\":\"ProfiledRegister\"") != std::string::npos);
+
+	// Unnamed calls are profiled under their source location
+	Mist::RegistrationProfiler::Clear();
+	const size_t unnamedLine = __LINE__ + 1;
+	Mist::PreMainCall unnamedRegister([&profiled]() { profiled.AddType<NonDefault>("ProfiledUnnamed"); });
+
+	records = Mist::RegistrationProfiler::GetRecords();
+	MIST_ASSERT(records.size() == 1 && records[0].m_Counters.m_TypeCount == 1);
+	MIST_ASSERT(records[0].m_Line == 0 || (records[0].m_Line == unnamedLine && std::strstr(records[0].m_Name, "main.cpp") != nullptr));
+
+	std::ostringstream unnamedReport;
+	Mist::RegistrationProfiler::WriteReport(unnamedReport);
+	MIST_ASSERT(records[0].m_Line == 0 || unnamedReport.str().find("main.cpp:" + std::to_string(unnamedLine)) != std::string::npos);
+#else
+	MIST_ASSERT(records.empty());
+#endif
+	MIST_ASSERT(profiled.GetType("Profiled")->HasMethod("Repeat"));
+
+	// -Binary Serializer-
+
+	struct SerialVector {
+		float m_X = 0.0f;
+		float m_Y = 0.0f;
+		float m_Z = 0.0f;
+	};
+
+	struct SerialRecord {
+		uint32_t GetId() { return m_Id; }
+
+		uint32_t m_Id = 0;
+		SerialVector m_Position;
+		std::string m_Name;
+		uint64_t m_Flags = 0;
+	};
+
+	// Not standard layout, members are resolved through their member pointers
+	struct SerialVirtual {
+		virtual ~SerialVirtual() = default;
+		uint32_t m_Value = 0;
+		std::string m_Text;
+	};
+
+	Mist::Reflection serialized;
+	Mist::TypeInfo* vectorInfo = serialized.AddType<SerialVector>("SerialVector");
+	vectorInfo->AddNamedMember("m_X", &SerialVector::m_X);
+	vectorInfo->AddNamedMember("m_Y", &SerialVector::m_Y);
+	vectorInfo->AddNamedMember("m_Z", &SerialVector::m_Z);
+	Mist::TypeInfo* recordInfo = serialized.AddType<SerialRecord>("SerialRecord");
+	recordInfo->AddNamedMember("m_Id", &SerialRecord::m_Id);
+	recordInfo->AddNamedMember("m_Position", &SerialRecord::m_Position);
+	recordInfo->AddNamedMember("m_Name", &SerialRecord::m_Name);
+	recordInfo->AddNamedMember("m_Flags", &SerialRecord::m_Flags);
+	Mist::TypeInfo* virtualInfo = serialized.AddType<SerialVirtual>("SerialVirtual");
+	virtualInfo->AddNamedMember("m_Value", &SerialVirtual::m_Value);
+	virtualInfo->AddNamedMember("m_Text", &SerialVirtual::m_Text);
+
+	// Only AddNamedMember keeps the name, runtime strings are hashed
+	Mist::Reflection runtimeNamed;
+	const std::string runtimeName("m_Data");
+	Mist::MemberInfo* runtimeMember = runtimeNamed.AddType<NonDefault>("RuntimeNamed")->AddMember(runtimeName.c_str(), &NonDefault::m_Data);
+	MIST_ASSERT(runtimeMember->GetName() == nullptr && runtimeNamed.GetType("RuntimeNamed")->HasMember("m_Data"));
+	MIST_ASSERT(std::strcmp(recordInfo->GetMemberInfo("m_Id")->GetName(), "m_Id") == 0);
+
+	Mist::BinarySerializer serializer(&serialized);
+	MIST_ASSERT(serializer.IsContiguous<SerialVector>());
+	MIST_ASSERT(serializer.IsContiguous<SerialRecord>() == false);
+
+	SerialRecord record;
+	record.m_Id = 7;
+	record.m_Position.m_X = 1.0f;
+	record.m_Position.m_Z = 3.0f;
+	record.m_Name = "Record";
+	record.m_Flags = CHANGE_TARGET;
+
+	std::vector<unsigned char> stream;
+	MIST_ASSERT(serializer.Write(record, &stream));
+	MIST_ASSERT(stream.size() == sizeof(uint32_t) + sizeof(SerialVector) + sizeof(uint64_t) + record.m_Name.size() + sizeof(uint64_t));
+
+	SerialRecord readRecord;
+	const unsigned char* cursor = stream.data();
+	MIST_ASSERT(serializer.Read(&cursor, stream.data() + stream.size(), &readRecord));
+	MIST_ASSERT(cursor == stream.data() + stream.size());
+	MIST_ASSERT(readRecord.m_Id == 7 && readRecord.m_Position.m_X == 1.0f && readRecord.m_Position.m_Z == 3.0f);
+	MIST_ASSERT(readRecord.m_Name == "Record" && readRecord.m_Flags == CHANGE_TARGET);
+
+	// Truncated streams are rejected
+	cursor = stream.data();
+	MIST_ASSERT(serializer.Read(&cursor, stream.data() + stream.size() - 1, &readRecord) == false);
+
+	SerialVector vectors[3];
+	vectors[2].m_Y = 5.0f;
+	stream.clear();
+	MIST_ASSERT(serializer.WriteArray(vectors, 3, &stream));
+	MIST_ASSERT(stream.size() == sizeof(vectors));
+
+	SerialVector readVectors[3];
+	cursor = stream.data();
+	MIST_ASSERT(serializer.ReadArray(&cursor, stream.data() + stream.size(), readVectors, 3));
+	MIST_ASSERT(readVectors[2].m_Y == 5.0f);
+
+	SerialVirtual virtualObject;
+	virtualObject.m_Value = 11;
+	virtualObject.m_Text = "Virtual";
+	stream.clear();
+	MIST_ASSERT(serializer.Write(virtualObject, &stream));
+
+	SerialVirtual readVirtual;
+	cursor = stream.data();
+	MIST_ASSERT(serializer.Read(&cursor, stream.data() + stream.size(), &readVirtual));
+	MIST_ASSERT(readVirtual.m_Value == 11 && readVirtual.m_Text == "Virtual");
+
+	// Type indices follow the types moved by a Merge even though the count didn't change
+	Mist::Reflection indexedSource;
+	Mist::Reflection indexedOutput;
+	indexedSource.AddType<SerialVector>("IndexedVector");
+	indexedOutput.AddType<SerialRecord>("IndexedRecord");
+	Mist::Detail::TypeIndex sourceIndex(&indexedSource);
+	Mist::Detail::TypeIndex outputIndex(&indexedOutput);
+	MIST_ASSERT(sourceIndex.Find(Mist::TypeId::Get<SerialVector>()) != nullptr);
+	MIST_ASSERT(outputIndex.Find(Mist::TypeId::Get<SerialVector>()) == nullptr);
+
+	Mist::Reflection indexedOther;
+	indexedOther.AddType<SerialVirtual>("IndexedVirtual");
+	Mist::Reflection* indexedSources[] = { &indexedSource };
+	Mist::Merge(indexedSources, 1, &indexedOther, 1);
+	indexedSource.AddType<SerialRecord>("IndexedRecord");
+	MIST_ASSERT(sourceIndex.Find(Mist::TypeId::Get<SerialVector>()) == nullptr);
+	MIST_ASSERT(sourceIndex.Find(Mist::TypeId::Get<SerialRecord>()) == indexedSource.GetType("IndexedRecord"));
+
+	// -Json Serializer-
+
+	Mist::JsonSerializer jsonSerializer(&serialized);
+
+	std::ostringstream json;
+	MIST_ASSERT(jsonSerializer.Write(record, json));
+	MIST_ASSERT(json.str().find("\"m_Position\":{\"m_X\":1,\"m_Y\":0,\"m_Z\":3}") != std::string::npos);
+
+	SerialRecord jsonRecord;
+	std::istringstream jsonInput(json.str());
+	MIST_ASSERT(jsonSerializer.Read(jsonInput, &jsonRecord));
+	MIST_ASSERT(jsonRecord.m_Id == 7 && jsonRecord.m_Position.m_Z == 3.0f && jsonRecord.m_Name == "Record" && jsonRecord.m_Flags == CHANGE_TARGET);
+
+	// Input split at every character, unknown fields are skipped
+	const std::string chunked = " { \"m_Unknown\" : [1, {\"a\": [true, null]}, \"]\"], \"m_Name\": \"Line\\n\\u00e9\\\"\", \"m_Id\": 42, \"m_Position\": {\"m_Y\": -2.5e1} } ";
+	SerialRecord chunkedRecord;
+	Mist::JsonReader jsonReader(&jsonSerializer);
+	jsonReader.Begin(&chunkedRecord);
+	for (char character : chunked) {
+		MIST_ASSERT(jsonReader.Feed(&character, 1));
+	}
+	MIST_ASSERT(jsonReader.Finish());
+	MIST_ASSERT(chunkedRecord.m_Id == 42 && chunkedRecord.m_Position.m_Y == -25.0f);
+	MIST_ASSERT(chunkedRecord.m_Name == "Line\n\xC3\xA9\"");
+
+	// Values that don't fit their field are rejected
+	const std::string mismatched = "{\"m_Id\": -1}";
+	jsonReader.Begin(&chunkedRecord);
+	MIST_ASSERT(jsonReader.Feed(mismatched.data(), mismatched.size()) == false);
+	MIST_ASSERT(jsonReader.HasError() && jsonReader.GetPosition() == 11);
+
+	// Top level arrays are read one element at a time
+	const std::string elements = "[{\"m_Value\": 1, \"m_Text\": \"One\"}, {\"m_Value\": 2}]";
+	SerialVirtual element;
+	size_t elementSum = 0;
+	jsonReader.BeginArray(&element, [&element, &elementSum]() { elementSum += element.m_Value * element.m_Text.size(); });
+	MIST_ASSERT(jsonReader.Feed(elements.data(), elements.size()));
+	MIST_ASSERT(jsonReader.Finish());
+	MIST_ASSERT(elementSum == 1 * 3 + 2 * 3);
+
+	// Members registered with a HashID have no name and are skipped
+	Mist::Reflection unnamed;
+	Mist::TypeInfo* unnamedInfo = unnamed.AddType<SerialVector>("UnnamedVector");
+	unnamedInfo->AddNamedMember("m_X", &SerialVector::m_X);
+	unnamedInfo->AddMember("m_Y", &SerialVector::m_Y);
+	Mist::JsonSerializer unnamedSerializer(&unnamed);
+
+	SerialVector unnamedVector;
+	unnamedVector.m_X = 1.0f;
+	unnamedVector.m_Y = 2.0f;
+	std::ostringstream unnamedJson;
+	MIST_ASSERT(unnamedSerializer.Write(unnamedVector, unnamedJson));
+	MIST_ASSERT(unnamedJson.str() == "{\"m_X\":1}");
+
+	std::istringstream unnamedInput("{\"m_X\": 3, \"m_Y\": 4}");
+	MIST_ASSERT(unnamedSerializer.Read(unnamedInput, &unnamedVector));
+	MIST_ASSERT(unnamedVector.m_X == 3.0f && unnamedVector.m_Y == 2.0f);
+
+	// -Schema Snapshot-
+
+	recordInfo->AddMethod("GetId", &SerialRecord::GetId);
+	recordInfo->GetMetaData()->Add("Version", uint32_t(3));
+	recordInfo->GetMetaData()->Add("Description", std::string("Not stored"));
+
+	const char* SNAPSHOT_PATH = "SchemaSnapshotTest.bin";
+	MIST_ASSERT(Mist::WriteSchemaSnapshot(&serialized, SNAPSHOT_PATH));
+
+	Mist::SchemaSnapshot snapshot;
+	MIST_ASSERT(snapshot.Open(SNAPSHOT_PATH));
+	MIST_ASSERT(snapshot.Matches(&serialized));
+	MIST_ASSERT(snapshot.GetTypeCount() == 3);
+
+	const Mist::SchemaType* recordSchema = snapshot.FindType("SerialRecord");
+	MIST_ASSERT(recordSchema != nullptr && recordSchema->m_MemberCount == 4 && recordSchema->m_MethodCount == 1);
+	MIST_ASSERT(std::string(snapshot.GetString(recordSchema->m_TypeName)).find("SerialRecord") != std::string::npos);
+	MIST_ASSERT(snapshot.FindType("Missing") == nullptr);
+
+	const Mist::SchemaMember* positionSchema = snapshot.FindMember(*recordSchema, "m_Position");
+	MIST_ASSERT(positionSchema->m_Offset == offsetof(SerialRecord, m_Position) && positionSchema->m_Size == sizeof(SerialVector));
+	MIST_ASSERT(positionSchema->m_TypeHash == snapshot.FindType("SerialVector")->m_TypeHash);
+	MIST_ASSERT(std::string(snapshot.GetString(positionSchema->m_MemberName)) == "m_Position");
+	MIST_ASSERT(snapshot.FindMember(*snapshot.FindType("SerialVirtual"), "m_Text")->m_Offset == Mist::SchemaMember::NO_OFFSET);
+	MIST_ASSERT(snapshot.FindMethod(*recordSchema, "GetId") != nullptr);
+
+	uint32_t version = 0;
+	float wrongType = 0.0f;
+	MIST_ASSERT(snapshot.ReadMetaData(*snapshot.FindMetaData(*recordSchema, "Version"), &version) && version == 3);
+	MIST_ASSERT(snapshot.ReadMetaData(*snapshot.FindMetaData(*recordSchema, "Version"), &wrongType) == false);
+	MIST_ASSERT(snapshot.FindMetaData(*recordSchema, "Description")->m_DataOffset == Mist::SchemaMetaData::NO_DATA);
+
+	// Layout changes make the snapshot stale
+	vectorInfo->GetMetaData()->Add("Hidden", true);
+	MIST_ASSERT(snapshot.Matches(&serialized) == false);
+	snapshot.Close();
+	std::remove(SNAPSHOT_PATH);
+
+	const uint64_t garbage[16] = {};
+	MIST_ASSERT(snapshot.Open(garbage, sizeof(garbage)) == false);
+	MIST_ASSERT(snapshot.IsOpen() == false);
+
+	// Fingerprints are cached until the schema changes
+	Mist::Reflection fingerprinted;
+	Mist::TypeInfo* fingerprintedType = fingerprinted.AddType<SerialVector>("FingerprintedVector");
+	fingerprintedType->AddMember("m_X", &SerialVector::m_X);
+	const uint64_t fingerprint = Mist::ComputeSchemaFingerprint(&fingerprinted);
+	MIST_ASSERT(Mist::ComputeSchemaFingerprint(&fingerprinted) == fingerprint);
+	fingerprintedType->AddMember("m_Y", &SerialVector::m_Y);
+	MIST_ASSERT(Mist::ComputeSchemaFingerprint(&fingerprinted) != fingerprint);
+
+	// Tables moved off their alignment are rejected even when the ranges are consistent
+	MIST_ASSERT(Mist::WriteSchemaSnapshot(&fingerprinted, SNAPSHOT_PATH));
+	std::ifstream snapshotFile(SNAPSHOT_PATH, std::ios::binary);
+	std::vector<char> snapshotBytes((std::istreambuf_iterator<char>(snapshotFile)), std::istreambuf_iterator<char>());
+	snapshotFile.close();
+	std::remove(SNAPSHOT_PATH);
+
+	std::vector<uint64_t> aligned((snapshotBytes.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+	std::memcpy(aligned.data(), snapshotBytes.data(), snapshotBytes.size());
+	MIST_ASSERT(snapshot.Open(aligned.data(), snapshotBytes.size()));
+	snapshot.Close();
+
+	Mist::Detail::SchemaHeader header;
+	std::memcpy(&header, snapshotBytes.data(), sizeof(header));
+	const uint64_t SHIFT = 4;
+	header.m_TypesOffset += SHIFT;
+	header.m_MembersOffset += SHIFT;
+	header.m_MethodsOffset += SHIFT;
+	header.m_MetaDataOffset += SHIFT;
+	header.m_StringsOffset += SHIFT;
+	header.m_DataOffset += SHIFT;
+	header.m_FileSize += SHIFT;
+
+	std::vector<uint64_t> shifted((snapshotBytes.size() + SHIFT + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+	unsigned char* shiftedBytes = reinterpret_cast<unsigned char*>(shifted.data());
+	std::memcpy(shiftedBytes, &header, sizeof(header));
+	std::memcpy(shiftedBytes + sizeof(header) + SHIFT, snapshotBytes.data() + sizeof(header), snapshotBytes.size() - sizeof(header));
+	MIST_ASSERT(snapshot.Open(shifted.data(), snapshotBytes.size() + SHIFT) == false);
+
+	// Offsets wrapping around once the table size is added are rejected
+	std::memcpy(&header, snapshotBytes.data(), sizeof(header));
+	header.m_TypesOffset = UINT64_MAX - 63;
+	header.m_TypeCount = 2;
+	std::memcpy(aligned.data(), &header, sizeof(header));
+	MIST_ASSERT(snapshot.Open(aligned.data(), snapshotBytes.size()) == false);
+
+	// -Object Diff-
+
+	Mist::ObjectDiff objectDiff(&serialized);
+
+	SerialRecord changedRecord = record;
+	changedRecord.m_Position.m_Y = 2.0f;
+	changedRecord.m_Name = "Changed";
+
+	// Only m_Y and m_Name are patched
+	std::vector<unsigned char> patch;
+	MIST_ASSERT(objectDiff.Diff(record, changedRecord, &patch));
+	MIST_ASSERT(patch.size() == 1 + sizeof(float) + 1 + sizeof(uint64_t) + changedRecord.m_Name.size() + 1);
+
+	SerialRecord patchedRecord = record;
+	cursor = patch.data();
+	MIST_ASSERT(objectDiff.Apply(&cursor, patch.data() + patch.size(), &patchedRecord));
+	MIST_ASSERT(cursor == patch.data() + patch.size());
+	MIST_ASSERT(patchedRecord.m_Position.m_Y == 2.0f && patchedRecord.m_Name == "Changed");
+	MIST_ASSERT(patchedRecord.m_Id == 7 && patchedRecord.m_Position.m_X == 1.0f && patchedRecord.m_Flags == CHANGE_TARGET);
+
+	// Truncated patches are rejected
+	cursor = patch.data();
+	MIST_ASSERT(objectDiff.Apply(&cursor, patch.data() + patch.size() - 1, &patchedRecord) == false);
+
+	patch.clear();
+	MIST_ASSERT(objectDiff.Diff(record, record, &patch) == false);
+	MIST_ASSERT(patch.size() == 1);
+
+	// Members resolved through their member pointers are patched as nested patches
+	SerialVirtual changedVirtual;
+	changedVirtual.m_Value = 11;
+	changedVirtual.m_Text = "Changed";
+
+	patch.clear();
+	MIST_ASSERT(objectDiff.Diff(virtualObject, changedVirtual, &patch));
+
+	SerialVirtual patchedVirtual;
+	patchedVirtual.m_Value = 11;
+	patchedVirtual.m_Text = "Virtual";
+	cursor = patch.data();
+	MIST_ASSERT(objectDiff.Apply(&cursor, patch.data() + patch.size(), &patchedVirtual));
+	MIST_ASSERT(patchedVirtual.m_Value == 11 && patchedVirtual.m_Text == "Changed");
+
+	// -Structural Hasher-
+
+	Mist::StructuralHasher hasher(&serialized);
+
+	SerialRecord equalRecord = record;
+	MIST_ASSERT(hasher.Equals(record, equalRecord));
+	MIST_ASSERT(hasher.Hash(record) == hasher.Hash(equalRecord));
+	MIST_ASSERT(hasher.Hash(&record, recordInfo) == hasher.Hash(record));
+
+	// Changes to bytewise runs and to strings are both seen
+	MIST_ASSERT(hasher.Equals(record, changedRecord) == false);
+	MIST_ASSERT(hasher.Hash(record) != hasher.Hash(changedRecord));
+	equalRecord.m_Name = "Other";
+	MIST_ASSERT(hasher.Equals(&record, &equalRecord, recordInfo) == false);
+	MIST_ASSERT(hasher.Hash(record) != hasher.Hash(equalRecord));
+
+	// Padding isn't compared
+	alignas(SerialVirtual) unsigned char zeroedStorage[sizeof(SerialVirtual)];
+	alignas(SerialVirtual) unsigned char filledStorage[sizeof(SerialVirtual)];
+	std::memset(zeroedStorage, 0x00, sizeof(zeroedStorage));
+	std::memset(filledStorage, 0xFF, sizeof(filledStorage));
+	SerialVirtual* zeroedVirtual = new (zeroedStorage) SerialVirtual(virtualObject);
+	SerialVirtual* filledVirtual = new (filledStorage) SerialVirtual(virtualObject);
+	MIST_ASSERT(hasher.Equals(*zeroedVirtual, *filledVirtual));
+	MIST_ASSERT(hasher.Hash(*zeroedVirtual) == hasher.Hash(*filledVirtual));
+	MIST_ASSERT(hasher.Equals(virtualObject, changedVirtual) == false);
+	zeroedVirtual->~SerialVirtual();
+	filledVirtual->~SerialVirtual();
+
+	// Members of types that aren't reflected are compared bytewise only without padding, padded types need functions
+	struct PaddedInner {
+		char m_Tag;
+		int m_Value;
+	};
+
+	struct PaddedHolder {
+		PaddedInner m_Inner;
+		int m_Count;
+	};
+
+	MIST_ASSERT(Mist::MemberInfo(&PaddedHolder::m_Count).IsPaddingFree());
+	MIST_ASSERT(Mist::MemberInfo(&SerialVector::m_X).IsPaddingFree());
+	MIST_ASSERT(Mist::MemberInfo(&PaddedHolder::m_Inner).IsPaddingFree() == false);
+	MIST_ASSERT(Mist::MemberInfo(&PaddedHolder::m_Inner).IsTriviallyCopyable());
+
+	Mist::Reflection padded;
+	padded.AddType<PaddedHolder>("PaddedHolder")->AddMember("m_Inner", &PaddedHolder::m_Inner);
+	padded.GetType("PaddedHolder")->AddMember("m_Count", &PaddedHolder::m_Count);
+
+	Mist::StructuralHasher paddedHasher(&padded);
+	paddedHasher.AddFunctions<PaddedInner>(
+		+[](const PaddedInner& inner) { return static_cast<uint64_t>(inner.m_Tag) * 31 + static_cast<uint64_t>(inner.m_Value); },
+		+[](const PaddedInner& left, const PaddedInner& right) { return left.m_Tag == right.m_Tag && left.m_Value == right.m_Value; });
+
+	alignas(PaddedHolder) unsigned char zeroedHolderStorage[sizeof(PaddedHolder)];
+	alignas(PaddedHolder) unsigned char filledHolderStorage[sizeof(PaddedHolder)];
+	std::memset(zeroedHolderStorage, 0x00, sizeof(zeroedHolderStorage));
+	std::memset(filledHolderStorage, 0xFF, sizeof(filledHolderStorage));
+	PaddedHolder* zeroedHolder = new (zeroedHolderStorage) PaddedHolder;
+	PaddedHolder* filledHolder = new (filledHolderStorage) PaddedHolder;
+	zeroedHolder->m_Inner.m_Tag = filledHolder->m_Inner.m_Tag = 'a';
+	zeroedHolder->m_Inner.m_Value = filledHolder->m_Inner.m_Value = 3;
+	zeroedHolder->m_Count = filledHolder->m_Count = 5;
+	MIST_ASSERT(paddedHasher.Equals(*zeroedHolder, *filledHolder));
+	MIST_ASSERT(paddedHasher.Hash(*zeroedHolder) == paddedHasher.Hash(*filledHolder));
+	filledHolder->m_Inner.m_Value = 4;
+	MIST_ASSERT(paddedHasher.Equals(*zeroedHolder, *filledHolder) == false);
+
+	// Diffs compare padded types through their codec as well
+	Mist::ObjectDiff paddedDiff(&padded);
+	paddedDiff.AddCodec<PaddedInner>(
+		+[](const PaddedInner& left, const PaddedInner& right) { return left.m_Tag == right.m_Tag && left.m_Value == right.m_Value; },
+		+[](const PaddedInner& inner, std::vector<unsigned char>* output) {
+			output->push_back(static_cast<unsigned char>(inner.m_Tag));
+			output->push_back(static_cast<unsigned char>(inner.m_Value));
+		},
+		+[](const unsigned char** cursor, const unsigned char* end, PaddedInner* inner) {
+			if (end - *cursor < 2) {
+				return false;
+			}
+			inner->m_Tag = static_cast<char>(*(*cursor)++);
+			inner->m_Value = *(*cursor)++;
+			return true;
+		});
+
+	filledHolder->m_Inner.m_Value = 3;
+	patch.clear();
+	MIST_ASSERT(paddedDiff.Diff(*zeroedHolder, *filledHolder, &patch) == false);
+	filledHolder->m_Inner.m_Value = 4;
+	patch.clear();
+	MIST_ASSERT(paddedDiff.Diff(*zeroedHolder, *filledHolder, &patch));
+	cursor = patch.data();
+	MIST_ASSERT(paddedDiff.Apply(&cursor, patch.data() + patch.size(), zeroedHolder));
+	MIST_ASSERT(zeroedHolder->m_Inner.m_Value == 4 && zeroedHolder->m_Count == 5);
+
+	// -Meta Data Index-
+
+	Mist::Reflection tagged;
+	Mist::TypeInfo* taggedType = tagged.AddType<SerialRecord>("TaggedRecord");
+	taggedType->GetMetaData()->Add("Editable", true);
+	Mist::MemberInfo* taggedMember = taggedType->AddMember("m_Id", &SerialRecord::m_Id);
+	taggedMember->GetMetaData()->Add("Editable", true);
+	taggedType->AddMethod("GetId", &SerialRecord::GetId)->GetMetaData()->Add("System", 1);
+	tagged.AddGlobalFunction("TaggedFunction", &ReturnNumber)->GetMetaData()->Add("System", 2);
+	tagged.AddGlobalObject("TaggedObject", &g_SomeGlobal)->GetMetaData()->Add("Editable", true);
+
+	const std::vector<Mist::TaggedInfo>& editable = tagged.FindTagged("Editable");
+	MIST_ASSERT(editable.size() == 3);
+	MIST_ASSERT(tagged.FindTagged("System").size() == 2);
+	MIST_ASSERT(tagged.FindTagged("Missing").empty());
+
+	bool isMemberTagged = false;
+	for (const Mist::TaggedInfo& info : editable) {
+		if (info.m_Kind == Mist::TaggedInfo::Kind::Member) {
+			isMemberTagged = info.GetMemberInfo() == taggedMember && info.m_Holder == taggedType && info.m_Name == Mist::HashID("m_Id").GetValue();
+		}
+	}
+	MIST_ASSERT(isMemberTagged);
+
+	// Merged infos are indexed under their new address and leave the index of their source
+	Mist::Reflection taggedModule;
+	Mist::TypeInfo* taggedModuleVector = taggedModule.AddType<SerialVector>("TaggedVector");
+	taggedModuleVector->GetMetaData()->Add("Editable", true);
+	taggedModuleVector->AddMember("m_Y", &SerialVector::m_Y)->GetMetaData()->Add("Hidden", true);
+	taggedModule.AddType<SerialRecord>("TaggedRecord")->GetMetaData()->Add("Editable", true);
+	Mist::Reflection* taggedModules[] = { &taggedModule };
+	Mist::MergeReport taggedReport = Mist::Merge(taggedModules, 1, &tagged, 1);
+	MIST_ASSERT(taggedReport.m_MergedTypeCount == 1);
+
+	MIST_ASSERT(tagged.FindTagged("Editable").size() == 4);
+	MIST_ASSERT(taggedModule.FindTagged("Editable").size() == 1);
+	MIST_ASSERT(taggedModule.FindTagged("Editable")[0].GetTypeInfo() == &taggedModule.GetTypes()->begin()->second);
+	MIST_ASSERT(taggedModule.FindTagged("Hidden").empty() && tagged.FindTagged("Hidden").size() == 1);
+	MIST_ASSERT(tagged.FindTagged("Hidden")[0].m_Holder == tagged.GetType("TaggedVector"));
+
+	size_t mergedTypeCount = 0;
+	for (const Mist::TaggedInfo& info : tagged.FindTagged("Editable")) {
+		if (info.m_Kind == Mist::TaggedInfo::Kind::Type && info.m_Name == Mist::HashID("TaggedVector").GetValue()) {
+			mergedTypeCount += info.GetTypeInfo() == tagged.GetType("TaggedVector") ? 1 : 0;
+		}
+	}
+	MIST_ASSERT(mergedTypeCount == 1);
+
+	tagged.GetType("TaggedVector")->AddMember("m_X", &SerialVector::m_X)->GetMetaData()->Add("System", 3);
+	MIST_ASSERT(tagged.FindTagged("System").size() == 3);
+
+	bool isAddedMemberTagged = false;
+	for (const Mist::TaggedInfo& info : tagged.FindTagged("System")) {
+		isAddedMemberTagged |= info.m_Kind == Mist::TaggedInfo::Kind::Member && info.m_Holder == tagged.GetType("TaggedVector");
+	}
+	MIST_ASSERT(isAddedMemberTagged);
+
+	// Merged infos stay indexed by the output once their source is destroyed
+	{
+		Mist::Reflection taggedTemporary;
+		taggedTemporary.AddType<SerialVector>("TaggedVector")->GetMetaData()->Add("Editable", true);
+		Mist::Reflection* taggedTemporaries[] = { &taggedTemporary };
+		Mist::Merge(taggedTemporaries, 1, &taggedModule, 1);
+	}
+	MIST_ASSERT(taggedModule.FindTagged("Editable").size() == 2);
+
+	// -Memory Stats-
+
+	Mist::Reflection measured;
+	Mist::TypeInfo* measuredRecord = measured.AddType<SerialRecord>("MeasuredRecord");
+	measuredRecord->AddConstructor<SerialRecord>();
+	measuredRecord->AddMember("m_Id", &SerialRecord::m_Id);
+	measuredRecord->AddMethod("GetId", &SerialRecord::GetId);
+	measured.AddType<SerialVector>("MeasuredVector");
+	measured.AddGlobalObject("MeasuredObject", &g_SomeGlobal);
+
+	Mist::MemoryStats measuredStats = measured.GetMemoryStats();
+	MIST_ASSERT(measuredStats.m_TypeCount == 2 && measuredStats.m_MethodCount == 1 && measuredStats.m_MemberCount == 1 && measuredStats.m_GlobalCount == 1);
+	MIST_ASSERT(measuredStats.m_TypeInfoBytes == 2 * sizeof(Mist::TypeInfo));
+	MIST_ASSERT(measuredStats.m_MethodInfoBytes == sizeof(Mist::MethodInfo) && measuredStats.m_MemberInfoBytes == sizeof(Mist::MemberInfo));
+	MIST_ASSERT(measuredStats.m_MetaDataBytes == 0 && measuredStats.m_AnyBytes == 0 && measuredStats.m_PoolBytes == 0);
+	MIST_ASSERT(measuredStats.m_HashTableBytes > 0);
+
+	// Meta data, heap values, pools and heap callables are accounted for
+	for (int i = 0; i < 3; ++i) {
+		const std::string key = "Measured" + std::to_string(i);
+		measuredRecord->GetMetaData()->Add(Mist::HashID(key.c_str(), key.size()), i);
+	}
+	measuredRecord->GetMetaData()->Add("MeasuredName", std::string("Record"));
+	measuredRecord->EnablePool(4);
+	measuredRecord->Destroy(measuredRecord->Create<SerialRecord>());
+
+	std::array<char, 64> measuredCapture = {};
+	measured.Defer("MeasuredDeferred", Mist::Delegate([measuredCapture](Mist::Reflection*) { (void)measuredCapture; }));
+
+	Mist::MemoryStats grownStats = measured.GetMemoryStats();
+	MIST_ASSERT(grownStats.m_MetaDataCount == measuredStats.m_MetaDataCount + 4);
+
+	// The four entries spill once they outgrow the inline ones, the heap block doubles from there
+	size_t measuredCapacity = MIST_METADATA_INLINE_CAPACITY;
+	while (measuredCapacity < 4) {
+		measuredCapacity *= 2;
+	}
+	const size_t measuredHeapCapacity = measuredCapacity > MIST_METADATA_INLINE_CAPACITY ? measuredCapacity : 0;
+	MIST_ASSERT(grownStats.m_MetaDataBytes == measuredHeapCapacity * sizeof(Mist::MetaData::Entry));
+	MIST_ASSERT(grownStats.m_AnyBytes == sizeof(Mist::Detail::AnyData<std::string>));
+	MIST_ASSERT(grownStats.m_PoolBytes >= 4 * sizeof(SerialRecord));
+	MIST_ASSERT(grownStats.m_DelegateBytes >= measuredStats.m_DelegateBytes + sizeof(Mist::Delegate) + sizeof(measuredCapture));
+
+	// Types are reported largest first and add up to the type categories of the registry
+	std::vector<Mist::TypeMemoryStats> measuredTypes = measured.GetTypeMemoryStats();
+	MIST_ASSERT(measuredTypes.size() == 2);
+	MIST_ASSERT(measuredTypes[0].m_Name == Mist::HashID("MeasuredRecord").GetValue() && measuredTypes[0].m_Type == measuredRecord);
+	MIST_ASSERT(measuredTypes[0].m_Stats.GetTotalBytes() >= measuredTypes[1].m_Stats.GetTotalBytes());
+
+	Mist::MemoryStats typeTotals;
+	for (const Mist::TypeMemoryStats& type : measuredTypes) {
+		typeTotals += type.m_Stats;
+	}
+	MIST_ASSERT(typeTotals.m_MetaDataBytes == grownStats.m_MetaDataBytes && typeTotals.m_PoolBytes == grownStats.m_PoolBytes);
+	MIST_ASSERT(typeTotals.GetTotalBytes() < grownStats.GetTotalBytes());
+
+	std::ostringstream memoryReport;
+	measured.WriteMemoryReport(memoryReport, 1);
+	MIST_ASSERT(memoryReport.str().find("Reflection memory: " + std::to_string(grownStats.GetTotalBytes()) + " bytes") == 0);
+	MIST_ASSERT(memoryReport.str().find("Largest types: 1 of 2") != std::string::npos);
+
+	// Published snapshots are accounted for until they're reclaimed
+	measured.Publish();
+	const Mist::MemoryStats publishedStats = measured.GetMemoryStats();
+	MIST_ASSERT(publishedStats.m_HashTableBytes > grownStats.m_HashTableBytes);
+
+	Mist::TypeInfo* publishedRecord = measured.GetType("MeasuredRecord");
+	measured.Publish();
+	MIST_ASSERT(measured.GetMemoryStats().m_HashTableBytes > publishedStats.m_HashTableBytes);
+	measured.ReclaimSnapshots();
+	MIST_ASSERT(measured.GetMemoryStats().m_HashTableBytes == publishedStats.m_HashTableBytes);
+	MIST_ASSERT(measured.GetType("MeasuredRecord") == publishedRecord && publishedRecord == measuredRecord);
+
+	typeInfo.Freeze();
+	MIST_ASSERT(typeInfo.HasMethod("Repeat"));
+	MIST_ASSERT(typeInfo.GetMethodInfo("Repeat") == repeatMethodInfo);
+	MIST_ASSERT(typeInfo.HasMethod("Lol") == false);
+	MIST_ASSERT(typeInfo.GetMemberInfo("m_Value") == valueMemberInfo);
+	MIST_ASSERT(typeInfo.HasMember("Lol") == false);
+	MIST_ASSERT(*typeInfo.GetMetaData()->Get<float>("Strength") == 10.0f);
+
 	std::cout << "Reflection Test Passed!" << std::endl;
 }
 